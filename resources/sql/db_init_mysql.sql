@@ -12,7 +12,7 @@ CREATE TABLE IF NOT EXISTS Information (
   inf_value       TEXT        NOT NULL
 );
 -- !
-INSERT INTO Information VALUES (1, 'schema_version', '11');
+INSERT INTO Information VALUES (1, 'schema_version', '12');
 -- !
 CREATE TABLE IF NOT EXISTS Accounts (
   id              INTEGER     PRIMARY KEY,
@@ -101,6 +101,9 @@ CREATE TABLE IF NOT EXISTS Feeds (
   type            INTEGER,
   account_id      INTEGER       NOT NULL,
   custom_id       TEXT,
+  http_etag       TEXT,
+  http_lastmod    TEXT,
+  content_hash    BIGINT,
   
   FOREIGN KEY (account_id) REFERENCES Accounts (id)
 );
@@ -123,6 +126,19 @@ CREATE TABLE IF NOT EXISTS Messages (
   account_id      INTEGER     NOT NULL,
   custom_id       TEXT,
   custom_hash     TEXT,
+  identity_hash   BIGINT,
   
   FOREIGN KEY (account_id) REFERENCES Accounts (id)
-);
\ No newline at end of file
+);
+-- !
+CREATE INDEX idx_messages_feed ON Messages (account_id, feed(191), is_deleted, is_pdeleted, is_read);
+-- !
+CREATE INDEX idx_messages_state ON Messages (account_id, is_deleted, is_pdeleted, is_read);
+-- !
+CREATE INDEX idx_messages_custom_id ON Messages (account_id, custom_id(191));
+-- !
+CREATE INDEX idx_messages_identity ON Messages (account_id, feed(191), identity_hash);
+-- !
+CREATE INDEX idx_messages_history ON Messages (account_id, feed(191), date_created);
+-- !
+CREATE INDEX idx_feeds_custom_id ON Feeds (account_id, custom_id(191));
\ No newline at end of file
@@ -6,7 +6,7 @@ CREATE TABLE IF NOT EXISTS Information (
   inf_value       TEXT        NOT NULL
 );
 -- !
-INSERT INTO Information VALUES (1, 'schema_version', '11');
+INSERT INTO Information VALUES (1, 'schema_version', '12');
 -- !
 CREATE TABLE IF NOT EXISTS Accounts (
   id              INTEGER     PRIMARY KEY,
@@ -95,6 +95,9 @@ CREATE TABLE IF NOT EXISTS Feeds (
   type            INTEGER,
   account_id      INTEGER     NOT NULL,
   custom_id       TEXT,
+  http_etag       TEXT,
+  http_lastmod    TEXT,
+  content_hash    INTEGER,
   
   FOREIGN KEY (account_id) REFERENCES Accounts (id)
 );
@@ -117,6 +120,19 @@ CREATE TABLE IF NOT EXISTS Messages (
   account_id      INTEGER     NOT NULL,
   custom_id       TEXT,
   custom_hash     TEXT,
+  identity_hash   INTEGER,
   
   FOREIGN KEY (account_id) REFERENCES Accounts (id)
-);
\ No newline at end of file
+);
+-- !
+CREATE INDEX IF NOT EXISTS idx_messages_feed ON Messages (account_id, feed, is_deleted, is_pdeleted, is_read);
+-- !
+CREATE INDEX IF NOT EXISTS idx_messages_state ON Messages (account_id, is_deleted, is_pdeleted, is_read);
+-- !
+CREATE INDEX IF NOT EXISTS idx_messages_custom_id ON Messages (account_id, custom_id);
+-- !
+CREATE INDEX IF NOT EXISTS idx_messages_identity ON Messages (account_id, feed, identity_hash);
+-- !
+CREATE INDEX IF NOT EXISTS idx_messages_history ON Messages (account_id, feed, date_created);
+-- !
+CREATE INDEX IF NOT EXISTS idx_feeds_custom_id ON Feeds (account_id, custom_id);
\ No newline at end of file
@@ -0,0 +1,27 @@
+ALTER TABLE Feeds
+ADD COLUMN http_etag TEXT;
+-- !
+ALTER TABLE Feeds
+ADD COLUMN http_lastmod TEXT;
+-- !
+ALTER TABLE Feeds
+ADD COLUMN content_hash INTEGER;
+-- !
+ALTER TABLE Messages
+ADD COLUMN identity_hash INTEGER;
+-- !
+CREATE INDEX IF NOT EXISTS idx_messages_feed ON Messages (account_id, feed, is_deleted, is_pdeleted, is_read);
+-- !
+CREATE INDEX IF NOT EXISTS idx_messages_state ON Messages (account_id, is_deleted, is_pdeleted, is_read);
+-- !
+CREATE INDEX IF NOT EXISTS idx_messages_custom_id ON Messages (account_id, custom_id);
+-- !
+CREATE INDEX IF NOT EXISTS idx_messages_identity ON Messages (account_id, feed, identity_hash);
+-- !
+CREATE INDEX IF NOT EXISTS idx_messages_history ON Messages (account_id, feed, date_created);
+-- !
+CREATE INDEX IF NOT EXISTS idx_feeds_custom_id ON Feeds (account_id, custom_id);
+-- !
+UPDATE Messages SET custom_id = id WHERE custom_id IS NULL OR custom_id = '';
+-- !
+UPDATE Information SET inf_value = '12' WHERE inf_key = 'schema_version';
\ No newline at end of file
@@ -25,6 +25,13 @@
 #                   Otherwise simple text component is used and some features will be disabled.
 #                   Default value is "false". If QtWebEngine is installed during compilation, then
 #                   value of this variable is tweaked automatically.
+#   USE_BROTLI - if "true", then feeds and service APIs are downloaded with brotli compression
+#                in addition to gzip/deflate, "libbrotlidec" and "zlib" libraries
+#                are then required (via pkg-config). Default value is "false". If both
+#                libraries are found during compilation, then value is tweaked automatically.
+#   BUILD_BENCHMARK - if "true", then benchmark of feed parsers and audit of DB query plans
+#                     is built instead of the application, it is run with "make benchmark".
+#                     Qt Test module is then required. Default value is "false".
 #   PREFIX - specifies base folder to which files are copied during "make install"
 #            step, defaults to "$$OUT_PWD/usr" on Linux and to "$$OUT_PWD/app" on Windows.
 #   LRELEASE_EXECUTABLE - specifies the name/path of "lrelease" executable, defaults to "lrelease".
@@ -102,6 +109,20 @@ isEmpty(USE_WEBENGINE) {
   }
 }
 
+isEmpty(USE_BROTLI) {
+  USE_BROTLI = false
+  message("rssguard: USE_BROTLI variable is not set.")
+
+  unix {
+    CONFIG *= link_pkgconfig
+
+    packagesExist(libbrotlidec zlib) {
+      USE_BROTLI = true
+      message("rssguard: Brotli and zlib libraries ARE installed, enabling brotli compression.")
+    }
+  }
+}
+
 message(rssguard: Shadow copy build directory \"$$OUT_PWD\".)
 
 isEmpty(LRELEASE_EXECUTABLE) {
@@ -187,6 +208,16 @@ else {
   message(rssguard: Application will be compiled without QtWebEngine module. Some features will be disabled.)
 }
 
+equals(USE_BROTLI, true) {
+  message(rssguard: Application will be compiled WITH brotli compression support.)
+  CONFIG *= link_pkgconfig
+  PKGCONFIG *= libbrotlidec zlib
+  DEFINES *= USE_BROTLI
+
+  HEADERS += src/network-web/contentdecoder.h
+  SOURCES += src/network-web/contentdecoder.cpp
+}
+
 # Make needed tweaks for RC file getting generated on Windows.
 win32 {
   RC_ICONS = resources/graphics/rssguard.ico
@@ -204,6 +235,8 @@ HEADERS +=  src/core/feeddownloader.h \
             src/core/feedsmodel.h \
             src/core/feedsproxymodel.h \
             src/core/message.h \
+            src/core/messagebatch.h \
+            src/core/messagesanitizer.h \
             src/core/messagesmodel.h \
             src/core/messagesmodelcache.h \
             src/core/messagesmodelsqllayer.h \
@@ -261,6 +294,7 @@ HEADERS +=  src/core/feeddownloader.h \
             src/gui/widgetwithstatus.h \
             src/miscellaneous/application.h \
             src/miscellaneous/autosaver.h \
+            src/miscellaneous/cancellationtoken.h \
             src/miscellaneous/databasecleaner.h \
             src/miscellaneous/databasefactory.h \
             src/miscellaneous/databasequeries.h \
@@ -275,11 +309,13 @@ HEADERS +=  src/core/feeddownloader.h \
             src/miscellaneous/settingsproperties.h \
             src/miscellaneous/simplecrypt/simplecrypt.h \
             src/miscellaneous/skinfactory.h \
+            src/miscellaneous/stringpool.h \
             src/miscellaneous/systemfactory.h \
             src/miscellaneous/textfactory.h \
             src/network-web/basenetworkaccessmanager.h \
             src/network-web/downloader.h \
             src/network-web/downloadmanager.h \
+            src/network-web/fetchengine.h \
             src/network-web/networkfactory.h \
             src/network-web/oauth2service.h \
             src/network-web/silentnetworkaccessmanager.h \
@@ -318,6 +354,7 @@ HEADERS +=  src/core/feeddownloader.h \
             src/services/owncloud/owncloudserviceroot.h \
             src/services/standard/atomparser.h \
             src/services/standard/feedparser.h \
+            src/services/standard/feedsniffer.h \
             src/services/standard/gui/formstandardcategorydetails.h \
             src/services/standard/gui/formstandardfeeddetails.h \
             src/services/standard/gui/formstandardimportexport.h \
@@ -344,6 +381,8 @@ SOURCES +=  src/core/feeddownloader.cpp \
             src/core/feedsmodel.cpp \
             src/core/feedsproxymodel.cpp \
             src/core/message.cpp \
+            src/core/messagebatch.cpp \
+            src/core/messagesanitizer.cpp \
             src/core/messagesmodel.cpp \
             src/core/messagesmodelcache.cpp \
             src/core/messagesmodelsqllayer.cpp \
@@ -401,6 +440,7 @@ SOURCES +=  src/core/feeddownloader.cpp \
             src/main.cpp \
             src/miscellaneous/application.cpp \
             src/miscellaneous/autosaver.cpp \
+            src/miscellaneous/cancellationtoken.cpp \
             src/miscellaneous/databasecleaner.cpp \
             src/miscellaneous/databasefactory.cpp \
             src/miscellaneous/databasequeries.cpp \
@@ -414,11 +454,13 @@ SOURCES +=  src/core/feeddownloader.cpp \
             src/miscellaneous/settings.cpp \
             src/miscellaneous/simplecrypt/simplecrypt.cpp \
             src/miscellaneous/skinfactory.cpp \
+            src/miscellaneous/stringpool.cpp \
             src/miscellaneous/systemfactory.cpp \
             src/miscellaneous/textfactory.cpp \
             src/network-web/basenetworkaccessmanager.cpp \
             src/network-web/downloader.cpp \
             src/network-web/downloadmanager.cpp \
+            src/network-web/fetchengine.cpp \
             src/network-web/networkfactory.cpp \
             src/network-web/oauth2service.cpp \
             src/network-web/silentnetworkaccessmanager.cpp \
@@ -454,6 +496,7 @@ SOURCES +=  src/core/feeddownloader.cpp \
             src/services/owncloud/owncloudserviceroot.cpp \
             src/services/standard/atomparser.cpp \
             src/services/standard/feedparser.cpp \
+            src/services/standard/feedsniffer.cpp \
             src/services/standard/gui/formstandardcategorydetails.cpp \
             src/services/standard/gui/formstandardfeeddetails.cpp \
             src/services/standard/gui/formstandardimportexport.cpp \
@@ -601,6 +644,32 @@ INCLUDEPATH +=  $$PWD/. \
                 $$PWD/src/gui/dialogs \
                 $$PWD/src/dynamic-shortcuts
 
+# Parser benchmark replaces "main.cpp" of the application, it runs over
+# corpus of feeds and service API payloads stored in "tests/benchmark/corpus".
+equals(BUILD_BENCHMARK, true) {
+  message(rssguard: Parser benchmark will be compiled instead of application.)
+
+  TARGET = $${TARGET}-benchmark
+  QT *= testlib
+  CONFIG *= console
+  CONFIG -= app_bundle
+  DEFINES += BENCHMARK_CORPUS_DIR='"\\\"$$PWD/tests/benchmark/corpus\\\""'
+
+  SOURCES -= src/main.cpp
+  HEADERS +=  tests/benchmark/allocationcounter.h \
+              tests/benchmark/parserbenchmark.h \
+              tests/benchmark/queryplanaudit.h
+  SOURCES +=  tests/benchmark/allocationcounter.cpp \
+              tests/benchmark/parserbenchmark.cpp \
+              tests/benchmark/queryplanaudit.cpp
+
+  benchmark.target = benchmark
+  benchmark.depends = first
+  benchmark.commands = $$shell_path($$OUT_PWD/$$TARGET)
+
+  QMAKE_EXTRA_TARGETS += benchmark
+}
+
 # Create new "make lupdate" target.
 lupdate.target = lupdate
 lupdate.commands = lupdate $$shell_path($$PWD/rssguard.pro)
@@ -3,23 +3,59 @@
 #include "core/feeddownloader.h"
 
 #include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/cancellationtoken.h"
+#include "miscellaneous/databasequeries.h"
+#include "miscellaneous/feedreader.h"
+#include "miscellaneous/textfactory.h"
 #include "services/abstract/cacheforserviceroot.h"
 #include "services/abstract/feed.h"
+#include "services/abstract/serviceroot.h"
 
+#include <QDateTime>
 #include <QDebug>
 #include <QMessageBox>
 #include <QMessageLogger>
 #include <QMutexLocker>
+#include <QSqlError>
+#include <QSqlQuery>
 #include <QString>
 #include <QThread>
 #include <QThreadPool>
+#include <QTimer>
+#include <QUrl>
+
+#include <utility>
 
 FeedDownloader::FeedDownloader(QObject* parent)
-  : QObject(parent), m_feeds(QList<Feed*>()), m_mutex(new QMutex()), m_threadPool(new QThreadPool(this)),
-  m_results(FeedDownloadResults()), m_feedsUpdated(0),
-  m_feedsUpdating(0), m_feedsOriginalCount(0) {
+  : QObject(parent), m_feeds(QList<Feed*>()), m_feedsOfAccounts(QHash<int, QStringList>()), m_mutex(new QMutex()),
+  m_threadPool(new QThreadPool(this)),
+  m_fetchEngine(new FetchEngine(this)), m_cancellationToken(new CancellationToken(this)),
+  m_deadlineTimer(new QTimer(this)), m_results(FeedDownloadResults()), m_feedsUpdated(0),
+  m_feedsUpdating(0), m_feedsOriginalCount(0), m_maxConcurrency(DEFAULT_CONCURRENT_UPDATES),
+  m_maxConcurrencyPerHost(DEFAULT_CONCURRENT_HOST_UPDATES), m_concurrency(1), m_averageLatency(0.0), m_errorRate(0.0),
+  m_hostHealth(QHash<QString, HostHealth>()), m_retryAfter(QHash<const Feed*, qint64>()),
+  m_storeQueue(std::vector<StoreJob>()), m_storeQueueMessages(0), m_storeQueueBytes(0), m_peakBytesInFlight(0),
+  m_storeTimer(new QTimer(this)) {
   qRegisterMetaType<FeedDownloadResults>("FeedDownloadResults");
-  m_threadPool->setMaxThreadCount(2);
+  m_threadPool->setMaxThreadCount(m_maxConcurrency);
+
+  m_deadlineTimer->setSingleShot(true);
+  m_deadlineTimer->setInterval(FEED_DOWNLOADER_UPDATE_DEADLINE);
+
+  connect(m_deadlineTimer, &QTimer::timeout, this, [this]() {
+    qWarning("Feed update did not finish in %d seconds, stopping it.", FEED_DOWNLOADER_UPDATE_DEADLINE / 1000);
+    stopRunningUpdate();
+  });
+
+  m_storeTimer->setSingleShot(true);
+  m_storeTimer->setInterval(FEED_DOWNLOADER_STORE_DELAY);
+
+  connect(m_storeTimer, &QTimer::timeout, this, [this]() {
+    QMutexLocker locker(m_mutex);
+
+    storeQueuedMessages();
+  });
 }
 
 FeedDownloader::~FeedDownloader() {
@@ -33,31 +69,210 @@ bool FeedDownloader::isUpdateRunning() const {
   return !m_feeds.isEmpty() || m_feedsUpdating > 0;
 }
 
-void FeedDownloader::updateAvailableFeeds() {
-  foreach (const Feed* feed, m_feeds) {
-    CacheForServiceRoot* cache = dynamic_cast<CacheForServiceRoot*>(feed->getParentServiceRoot());
+void FeedDownloader::loadConcurrencyLimits() {
+  m_maxConcurrency = qBound(1,
+                            qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::MaxConcurrentUpdates)).toInt(),
+                            FEED_DOWNLOADER_MAX_CONNECTIONS);
+  m_maxConcurrencyPerHost = qBound(1,
+                                   qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::MaxConcurrentUpdatesPerHost)).toInt(),
+                                   m_maxConcurrency);
+
+  // We start in the middle and let the feedback loop find the right value.
+  m_concurrency = qMax(1, m_maxConcurrency / 2);
+  m_averageLatency = 0.0;
+  m_errorRate = 0.0;
 
-    if (cache != nullptr) {
-      qDebug("Saving cache for feed with DB ID %d and title '%s'.", feed->id(), qPrintable(feed->title()));
-      cache->saveAllCachedData(false);
+  // Threads are needed only for parsing and for feeds which
+  // cannot be fetched via fetch engine.
+  m_threadPool->setMaxThreadCount(qMin(FEED_DOWNLOADER_MAX_THREADS, qMax(m_maxConcurrency, QThread::idealThreadCount())));
+
+  qDebug("Feed downloader uses at most %d concurrent downloads (%d per host).", m_maxConcurrency, m_maxConcurrencyPerHost);
+}
+
+void FeedDownloader::adjustConcurrency(qint64 latency, bool error_during_obtaining) {
+  // Exponential moving averages of latency and error rate of recent downloads.
+  m_averageLatency = m_averageLatency <= 0.0 ? latency : (0.8 * m_averageLatency + 0.2 * latency);
+  m_errorRate = 0.8 * m_errorRate + (error_during_obtaining ? 0.2 : 0.0);
+
+  const int old_concurrency = m_concurrency;
+
+  if (error_during_obtaining) {
+    // Single dead feed should not throttle whole update, so we
+    // back off only if errors start to pile up.
+    if (m_errorRate > 0.3) {
+      m_concurrency = qMax(1, m_concurrency / 2);
     }
   }
+  else if (latency > FEED_DOWNLOADER_SLOW_RESPONSE) {
+    m_concurrency = qMax(1, m_concurrency - 1);
+  }
+  else if (latency <= 2 * m_averageLatency) {
+    m_concurrency = qMin(m_maxConcurrency, m_concurrency + 1);
+  }
+
+  if (old_concurrency != m_concurrency) {
+    qDebug("Feed downloader changed concurrency from %d to %d (average latency %.0f ms, error rate %.2f).",
+           old_concurrency, m_concurrency, m_averageLatency, m_errorRate);
+  }
+}
+
+QString FeedDownloader::hostOfFeed(const Feed* feed) {
+  return QUrl(feed->url()).host().toLower();
+}
+
+qint64 FeedDownloader::retryAfter(const FetchResult& result) {
+  if (result.m_httpCode != HTTP_CODE_TOO_MANY_REQUESTS && result.m_httpCode != HTTP_CODE_SERVICE_UNAVAILABLE) {
+    return 0;
+  }
+
+  // Header contains either number of seconds or HTTP date.
+  const QString value = QString::fromLatin1(result.header(HTTP_HEADERS_RETRY_AFTER)).trimmed();
+  const qint64 max_delay = qint64(FEED_BACKOFF_MAX_INTERVAL) * 60000;
+  bool is_number;
+  const qint64 seconds = value.toLongLong(&is_number);
+
+  if (is_number) {
+    return qBound(Q_INT64_C(0), seconds * 1000, max_delay);
+  }
+  else if (!value.isEmpty()) {
+    const QDateTime retry_date = TextFactory::parseDateTime(value);
+
+    if (retry_date.isValid()) {
+      return qBound(Q_INT64_C(0), QDateTime::currentDateTimeUtc().msecsTo(retry_date), max_delay);
+    }
+  }
+
+  // Server wants us to slow down but it did not say how much.
+  return result.m_httpCode == HTTP_CODE_TOO_MANY_REQUESTS ? qint64(FEED_BACKOFF_BASE_INTERVAL) * 60000 : 0;
+}
+
+bool FeedDownloader::isHostBlocked(const QString& host) const {
+  return m_hostHealth.contains(host) && m_hostHealth.value(host).m_blockedUntil > QDateTime::currentMSecsSinceEpoch();
+}
+
+void FeedDownloader::updateHostHealth(const QString& host, const FetchResult& result, qint64 retry_after) {
+  HostHealth& health = m_hostHealth[host];
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+  if (result.m_httpCode <= 0 && result.m_error != QNetworkReply::NoError) {
+    // There is no HTTP response at all, host is unreachable or it does not respond in time.
+    if (++health.m_failures >= HOST_CIRCUIT_BREAKER_FAILURES) {
+      health.m_blockedUntil = now + Feed::backoffDelay(health.m_failures - HOST_CIRCUIT_BREAKER_FAILURES + 1);
+      qWarning("Host '%s' failed %d times in a row, its feeds are skipped for %lld seconds.",
+               qPrintable(host), health.m_failures, (health.m_blockedUntil - now) / 1000);
+    }
+  }
+  else {
+    health.m_failures = 0;
+  }
+
+  if (retry_after > 0) {
+    qDebug("Host '%s' asked us to wait for %lld seconds.", qPrintable(host), retry_after / 1000);
+    health.m_blockedUntil = qMax(health.m_blockedUntil, now + retry_after);
+  }
+
+  if (health.m_failures == 0 && health.m_blockedUntil <= now) {
+    // Host is healthy, no need to remember it.
+    m_hostHealth.remove(host);
+  }
+}
 
-  while (!m_feeds.isEmpty()) {
-    connect(m_feeds.first(), &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished,
-            (Qt::ConnectionType)(Qt::UniqueConnection | Qt::AutoConnection));
+void FeedDownloader::updateAvailableFeeds() {
+  if (m_cancellationToken->isCancelled()) {
+    // Update was stopped, remaining feeds are not updated at all.
+    m_feeds.clear();
+    return;
+  }
+
+  // Feeds whose data are downloaded wait for parsing in thread pool, we do not
+  // start new downloads if parsers cannot keep up with them.
+  const int max_waiting_for_parsing = 2 * m_threadPool->maxThreadCount();
+
+  for (int i = 0;
+       i < m_feeds.size() && m_runningFeeds.size() < m_concurrency &&
+       m_feedsUpdating - m_runningFeeds.size() < max_waiting_for_parsing;) {
+    Feed* feed = m_feeds.at(i);
+    const QString host = hostOfFeed(feed);
+
+    if (isHostBlocked(host)) {
+      // Host is down or it asked us to wait, do not waste connections on it.
+      qDebug("Skipping feed '%s', its host '%s' is blocked.", qPrintable(feed->customId()), qPrintable(host));
+      m_feeds.removeAt(i);
+      m_results.appendSkippedFeed();
+      feedProcessed(feed, 0);
+      continue;
+    }
 
-    if (m_threadPool->tryStart(m_feeds.first())) {
-      m_feeds.removeFirst();
-      m_feedsUpdating++;
+    if (m_runningPerHost.value(host) >= m_maxConcurrencyPerHost) {
+      // This host is saturated, look for feed from another host.
+      i++;
+      continue;
+    }
+
+    FetchRequest request;
+
+    feed->setCancellationToken(m_cancellationToken);
+
+    if (feed->prepareFetch(request)) {
+      // Feed data are downloaded by our fetch engine and the feed
+      // goes to thread pool once its data are ready.
+      m_fetchEngine->fetch(request, [this, feed](const FetchResult& result) {
+        oneFeedFetched(feed, result);
+      });
     }
     else {
-      qCritical("User wanted to update some feeds but all working threads are occupied.");
+      connect(feed, &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished,
+              (Qt::ConnectionType)(Qt::UniqueConnection | Qt::AutoConnection));
+
+      if (!m_threadPool->tryStart(feed)) {
+        // All working threads are occupied, look for feed
+        // which can be fetched without thread.
+        i++;
+        continue;
+      }
+    }
+
+    m_feeds.removeAt(i);
+    m_feedsUpdating++;
+    m_runningPerHost[host]++;
+    m_runningFeeds.insert(feed, RunningFeed { host, m_updateTimer.elapsed() });
+  }
+}
+
+void FeedDownloader::releaseRunningFeed(const Feed* feed, bool error_during_obtaining) {
+  if (m_runningFeeds.contains(feed)) {
+    const RunningFeed running = m_runningFeeds.take(feed);
 
-      // We want to start update of some feeds but all working threads are occupied.
-      break;
+    if (--m_runningPerHost[running.m_host] <= 0) {
+      m_runningPerHost.remove(running.m_host);
+    }
+
+    adjustConcurrency(m_updateTimer.elapsed() - running.m_startedAt, error_during_obtaining);
+  }
+}
+
+void FeedDownloader::oneFeedFetched(Feed* feed, const FetchResult& result) {
+  QMutexLocker locker(m_mutex);
+
+  releaseRunningFeed(feed, result.m_error != QNetworkReply::NoError);
+
+  if (!m_cancellationToken->isCancelled()) {
+    const qint64 retry_after = retryAfter(result);
+
+    updateHostHealth(hostOfFeed(feed), result, retry_after);
+
+    if (retry_after > 0) {
+      m_retryAfter.insert(feed, retry_after);
     }
   }
+
+  // Data are here, let the feed process them in thread pool.
+  feed->setFetchResult(result);
+  connect(feed, &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished,
+          (Qt::ConnectionType)(Qt::UniqueConnection | Qt::AutoConnection));
+  m_threadPool->start(feed);
+
+  updateAvailableFeeds();
 }
 
 void FeedDownloader::updateFeeds(const QList<Feed*>& feeds) {
@@ -69,60 +284,248 @@ void FeedDownloader::updateFeeds(const QList<Feed*>& feeds) {
   }
   else {
     qDebug().nospace() << "Starting feed updates from worker in thread: \'" << QThread::currentThreadId() << "\'.";
+
+    foreach (const Feed* feed, feeds) {
+      CacheForServiceRoot* cache = dynamic_cast<CacheForServiceRoot*>(feed->getParentServiceRoot());
+
+      if (cache != nullptr) {
+        qDebug("Saving cache for feed with DB ID %d and title '%s'.", feed->id(), qPrintable(feed->title()));
+        cache->saveAllCachedData(false);
+      }
+    }
+
     m_feeds = feeds;
     m_feedsOriginalCount = m_feeds.size();
+    m_feedsOfAccounts.clear();
+
+    foreach (const Feed* feed, feeds) {
+      m_feedsOfAccounts[feed->getParentServiceRoot()->accountId()].append(feed->customId());
+    }
+
     m_results.clear();
     m_feedsUpdated = m_feedsUpdating = 0;
+    m_runningPerHost.clear();
+    m_runningFeeds.clear();
+    m_retryAfter.clear();
+    m_storeQueue.clear();
+    m_storeQueueMessages = 0;
+    m_storeQueueBytes = 0;
+    m_peakBytesInFlight = MessageBatch::bytesInFlight();
+    m_updateTimer.start();
+    m_cancellationToken->reset();
+    m_deadlineTimer->start();
+    loadConcurrencyLimits();
+
+    // Downloads made by fetch engine are aborted with the token too.
+    CancellationToken::setCurrent(m_cancellationToken);
 
     // Job starts now.
     emit updateStarted();
 
     updateAvailableFeeds();
+
+    if (m_feeds.isEmpty() && m_feedsUpdating <= 0) {
+      // All feeds were skipped.
+      finalizeUpdate();
+    }
   }
 }
 
 void FeedDownloader::stopRunningUpdate() {
-  m_threadPool->clear();
-  m_feeds.clear();
+  // Feeds which wait in thread pool are not removed from it, they
+  // return immediately once started, so that we get results of all
+  // running feeds and update finishes properly.
+  m_cancellationToken->cancel();
 }
 
-void FeedDownloader::oneFeedUpdateFinished(const QList<Message>& messages, bool error_during_obtaining) {
+void FeedDownloader::oneFeedUpdateFinished() {
   QMutexLocker locker(m_mutex);
 
-  m_feedsUpdated++;
   m_feedsUpdating--;
   Feed* feed = qobject_cast<Feed*>(sender());
 
   disconnect(feed, &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished);
 
+  // Messages are moved out of the feed, nothing gets copied.
+  MessageBatch batch = feed->takeObtainedMessages();
+  const bool error_during_obtaining = batch.errorDuringObtaining();
+
+  m_peakBytesInFlight = qMax(m_peakBytesInFlight, MessageBatch::bytesInFlight());
+
+  releaseRunningFeed(feed, error_during_obtaining);
+
+  if (m_cancellationToken->isCancelled()) {
+    // Update was stopped, messages of this feed might be incomplete.
+    m_retryAfter.remove(feed);
+  }
+  else if (error_during_obtaining) {
+    feed->registerUpdateFailure(m_retryAfter.take(feed));
+  }
+  else {
+    m_retryAfter.remove(feed);
+    feed->registerUpdateSuccess();
+  }
+
   // Now, we check if there are any feeds we would like to update too.
   updateAvailableFeeds();
 
+  if (m_cancellationToken->isCancelled()) {
+    qDebug("Feed update was stopped, messages of feed %s are discarded.", qPrintable(feed->customId()));
+    feedProcessed(feed, 0);
+  }
+  else if (feed->contentsUnchanged()) {
+    // Feed did not change since last update, there is nothing to store.
+    qDebug("Contents of feed %s did not change, skipping DB update.", qPrintable(feed->customId()));
+    m_results.appendUnchangedFeed();
+
+    if (feed->status() != Feed::Normal && feed->status() != Feed::NewMessages) {
+      feed->setStatus(Feed::Normal);
+      feed->getParentServiceRoot()->itemChanged(QList<RootItem*>() << feed);
+    }
+
+    feedProcessed(feed, 0);
+  }
+  else {
+    m_storeQueueMessages += batch.size();
+    m_storeQueueBytes += batch.sizeInBytes();
+    m_storeQueue.push_back(StoreJob { feed, std::move(batch) });
+  }
+
+  if (m_feeds.isEmpty() && m_feedsUpdating <= 0) {
+    // This was the last feed, store whatever is left.
+    storeQueuedMessages();
+    finalizeUpdate();
+  }
+  else if (int(m_storeQueue.size()) >= FEED_DOWNLOADER_STORE_BATCH ||
+           m_storeQueueMessages >= FEED_DOWNLOADER_STORE_BATCH_MESSAGES ||
+           m_storeQueueBytes >= FEED_DOWNLOADER_STORE_BATCH_BYTES) {
+    storeQueuedMessages();
+  }
+  else if (!m_storeQueue.empty() && !m_storeTimer->isActive()) {
+    // Give other feeds a chance to get stored in the same transaction.
+    m_storeTimer->start();
+  }
+}
+
+void FeedDownloader::storeQueuedMessages() {
+  m_storeTimer->stop();
+
+  if (m_storeQueue.empty()) {
+    return;
+  }
+
+  std::vector<StoreJob> jobs;
+
+  jobs.swap(m_storeQueue);
+
+  const int jobs_count = int(jobs.size());
+
   // Now make sure, that messages are actually stored to SQL in a locked state.
-  qDebug().nospace() << "Saving messages of feed ID "
-                     << feed->customId() << " URL: " << feed->url() << " title: " << feed->title() << " in thread: \'"
-                     << QThread::currentThreadId() << "\'.";
+  qDebug().nospace() << "Saving " << m_storeQueueMessages << " messages (" << m_storeQueueBytes / 1024 << " kB) of "
+                     << jobs_count << " feeds in thread: \'" << QThread::currentThreadId() << "\', "
+                     << MessageBatch::bytesInFlight() / 1024 << " kB of messages are in flight.";
+
+  m_storeQueueMessages = 0;
+  m_storeQueueBytes = 0;
+
+  QSqlDatabase database = qApp->database()->connection(QSL(APP_DB_WRITER_CONNECTION), DatabaseFactory::FromSettings);
+  const bool use_transactions = qApp->settings()->value(GROUP(Database), SETTING(Database::UseTransactions)).toBool();
+  QSqlQuery query_begin_transaction(database);
+  const bool in_transaction = use_transactions && query_begin_transaction.exec(qApp->database()->obtainBeginTransactionSql());
+
+  if (use_transactions && !in_transaction) {
+    qCritical("Transaction start for batch of %d feeds failed: '%s', storing feeds one by one.",
+              jobs_count, qPrintable(query_begin_transaction.lastError().text()));
+  }
 
-  int updated_messages = feed->updateMessages(messages, error_during_obtaining);
+  bool batched = in_transaction || !use_transactions;
+  QList<int> updated_messages;
 
-  qDebug("%d messages for feed %s stored in DB.", updated_messages, qPrintable(feed->customId()));
+  for (int i = 0; i < jobs_count; i++) {
+    StoreJob& job = jobs[i];
+
+    qDebug().nospace() << "Saving messages of feed ID " << job.m_feed->customId() << " URL: " << job.m_feed->url()
+                       << " title: " << job.m_feed->title() << ".";
+    updated_messages.append(job.m_feed->updateMessages(job.m_batch.messages(), job.m_batch.errorDuringObtaining(), batched));
+  }
+
+  if (in_transaction && !database.commit()) {
+    qCritical("Transaction commit for batch of %d feeds failed: '%s', storing feeds one by one.",
+              jobs_count, qPrintable(database.lastError().text()));
+    database.rollback();
+    batched = false;
+    updated_messages.clear();
+
+    for (int i = 0; i < jobs_count; i++) {
+      StoreJob& job = jobs[i];
+
+      updated_messages.append(job.m_feed->updateMessages(job.m_batch.messages(), job.m_batch.errorDuringObtaining()));
+    }
+  }
+
+  if (batched) {
+    // Download states of feeds were committed together with their messages.
+    for (int i = 0; i < jobs_count; i++) {
+      jobs[i].m_feed->commitFetchState();
+    }
+  }
+
+  // Writer connection does not checkpoint on its own, stored
+  // messages are moved to database file now, without blocking readers.
+  qApp->database()->checkpointDatabase(database);
+
+  for (int i = 0; i < jobs_count; i++) {
+    qDebug("%d messages for feed %s stored in DB.", updated_messages.at(i), qPrintable(jobs[i].m_feed->customId()));
+    feedProcessed(jobs[i].m_feed, updated_messages.at(i));
+  }
+}
+
+void FeedDownloader::feedProcessed(Feed* feed, int updated_messages) {
+  m_feedsUpdated++;
 
   if (updated_messages > 0) {
     m_results.appendUpdatedFeed(QPair<QString, int>(feed->title(), updated_messages));
   }
 
   qDebug("Made progress in feed updates, total feeds count %d/%d (id of feed is %d).", m_feedsUpdated, m_feedsOriginalCount, feed->id());
-  emit updateProgress(feed, m_feedsUpdated, m_feedsOriginalCount);
-
-  if (m_feeds.isEmpty() && m_feedsUpdating <= 0) {
-    finalizeUpdate();
-  }
+  emit updateProgress(feed, m_feedsUpdated, m_feedsOriginalCount, m_runningFeeds.size(), m_concurrency);
 }
 
 void FeedDownloader::finalizeUpdate() {
-  qDebug().nospace() << "Finished feed updates in thread: \'" << QThread::currentThreadId() << "\'.";
+  m_deadlineTimer->stop();
+  CancellationToken::setCurrent(nullptr);
+
+  qDebug().nospace() << "Finished feed updates in thread: \'" << QThread::currentThreadId() << "\', "
+                     << m_results.unchangedFeeds() << " unchanged feeds were skipped, "
+                     << m_results.skippedFeeds() << " feeds of blocked hosts were skipped, "
+                     << "at most " << m_peakBytesInFlight / 1024 << " kB of messages were in flight.";
   m_results.sort();
 
+  if (!m_feedsOfAccounts.isEmpty() && qApp->feedReader()->adaptiveAutoUpdateEnabled()) {
+    // Publishing rates of updated feeds might have changed. They are evaluated
+    // here, so that GUI thread does not need to query DB for them.
+    QSqlDatabase database = qApp->database()->connection(QSL(APP_DB_WRITER_CONNECTION), DatabaseFactory::FromSettings);
+    const qint64 since = QDateTime::currentDateTimeUtc().toMSecsSinceEpoch() - qint64(ADAPTIVE_UPDATE_HISTORY_DAYS) * 24 * 60 * 60 * 1000;
+    QHashIterator<int, QStringList> i(m_feedsOfAccounts);
+
+    while (i.hasNext()) {
+      i.next();
+
+      bool ok;
+      const QMap<QString, QPair<int, qint64>> history = DatabaseQueries::getPublishingHistoryForFeeds(database, i.key(), i.value(),
+                                                                                                      since, &ok);
+
+      if (ok) {
+        m_results.setPublishingHistory(i.key(), history);
+      }
+      else {
+        qWarning("Failed to obtain publishing history of feeds of account %d.", i.key());
+      }
+    }
+  }
+
+  m_feedsOfAccounts.clear();
+
   // Update of feeds has finished.
   // NOTE: This means that now "update lock" can be unlocked
   // and feeds can be added/edited/deleted and application
@@ -130,7 +533,9 @@ void FeedDownloader::finalizeUpdate() {
   emit updateFinished(m_results);
 }
 
-FeedDownloadResults::FeedDownloadResults() : m_updatedFeeds(QList<QPair<QString, int>>()) {}
+FeedDownloadResults::FeedDownloadResults()
+  : m_updatedFeeds(QList<QPair<QString, int>>()), m_publishingHistory(QHash<int, QMap<QString, QPair<int, qint64>>>()),
+  m_unchangedFeeds(0), m_skippedFeeds(0) {}
 
 QString FeedDownloadResults::overview(int how_many_feeds) const {
   QStringList result;
@@ -148,10 +553,34 @@ QString FeedDownloadResults::overview(int how_many_feeds) const {
   return res_str;
 }
 
+QHash<int, QMap<QString, QPair<int, qint64>>> FeedDownloadResults::publishingHistory() const {
+  return m_publishingHistory;
+}
+
+void FeedDownloadResults::setPublishingHistory(int account_id, const QMap<QString, QPair<int, qint64>>& history) {
+  m_publishingHistory.insert(account_id, history);
+}
+
 void FeedDownloadResults::appendUpdatedFeed(const QPair<QString, int>& feed) {
   m_updatedFeeds.append(feed);
 }
 
+void FeedDownloadResults::appendUnchangedFeed() {
+  m_unchangedFeeds++;
+}
+
+int FeedDownloadResults::unchangedFeeds() const {
+  return m_unchangedFeeds;
+}
+
+void FeedDownloadResults::appendSkippedFeed() {
+  m_skippedFeeds++;
+}
+
+int FeedDownloadResults::skippedFeeds() const {
+  return m_skippedFeeds;
+}
+
 void FeedDownloadResults::sort() {
   qSort(m_updatedFeeds.begin(), m_updatedFeeds.end(), FeedDownloadResults::lessThan);
 }
@@ -162,6 +591,9 @@ bool FeedDownloadResults::lessThan(const QPair<QString, int>& lhs, const QPair<Q
 
 void FeedDownloadResults::clear() {
   m_updatedFeeds.clear();
+  m_publishingHistory.clear();
+  m_unchangedFeeds = 0;
+  m_skippedFeeds = 0;
 }
 
 QList<QPair<QString, int>> FeedDownloadResults::updatedFeeds() const {
@@ -5,13 +5,23 @@
 
 #include <QObject>
 
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
 #include <QPair>
+#include <QStringList>
 
 #include "core/message.h"
+#include "core/messagebatch.h"
+#include "network-web/fetchengine.h"
 
+#include <vector>
+
+class CancellationToken;
 class Feed;
 class QThreadPool;
 class QMutex;
+class QTimer;
 
 // Represents results of batch feed updates.
 class FeedDownloadResults {
@@ -21,7 +31,22 @@ class FeedDownloadResults {
     QList<QPair<QString, int>> updatedFeeds() const;
     QString overview(int how_many_feeds) const;
 
+    // Number of feeds whose processing was skipped
+    // because their contents did not change.
+    int unchangedFeeds() const;
+
+    // Number of feeds which were not downloaded at all
+    // because their host is failing or asked us to wait.
+    int skippedFeeds() const;
+
+    // Publishing history of updated feeds keyed by account ID, it is
+    // obtained only if adaptive auto-update is enabled.
+    QHash<int, QMap<QString, QPair<int, qint64>>> publishingHistory() const;
+    void setPublishingHistory(int account_id, const QMap<QString, QPair<int, qint64>>& history);
+
     void appendUpdatedFeed(const QPair<QString, int>& feed);
+    void appendUnchangedFeed();
+    void appendSkippedFeed();
     void sort();
     void clear();
 
@@ -31,9 +56,15 @@ class FeedDownloadResults {
 
     // QString represents title if the feed, int represents count of newly downloaded messages.
     QList<QPair<QString, int>> m_updatedFeeds;
+    QHash<int, QMap<QString, QPair<int, qint64>>> m_publishingHistory;
+    int m_unchangedFeeds;
+    int m_skippedFeeds;
 };
 
 // This class offers means to "update" feeds and "special" categories.
+// Update runs as a pipeline: feeds are downloaded by fetch engine, parsed
+// in thread pool and their messages are then stored in batches, many feeds
+// in one DB transaction, by the thread this object lives in.
 // NOTE: This class is used within separate thread.
 class FeedDownloader : public QObject {
   Q_OBJECT
@@ -54,11 +85,13 @@ class FeedDownloader : public QObject {
     // Appropriate signals are emitted.
     void updateFeeds(const QList<Feed*>& feeds);
 
-    // Stops running update.
+    // Stops running update. Running downloads and parsers
+    // are aborted right away.
+    // NOTE: This method is thread-safe.
     void stopRunningUpdate();
 
   private slots:
-    void oneFeedUpdateFinished(const QList<Message>& messages, bool error_during_obtaining);
+    void oneFeedUpdateFinished();
 
   signals:
 
@@ -73,19 +106,86 @@ class FeedDownloader : public QObject {
     // "Current" number indicates count of processed feeds
     // and "total" number indicates total number of feeds
     // which were in the initial queue.
-    void updateProgress(const Feed* feed, int current, int total);
+    // "Running" is number of feeds which are being downloaded right now
+    // and "capacity" is current (adaptive) limit of concurrent downloads.
+    void updateProgress(const Feed* feed, int current, int total, int running, int capacity);
 
   private:
+    struct RunningFeed {
+      QString m_host;
+      qint64 m_startedAt;
+    };
+
+    // Health of single host, all feeds of the host are skipped
+    // until "m_blockedUntil" (msecs since epoch).
+    struct HostHealth {
+      int m_failures;
+      qint64 m_blockedUntil;
+    };
+
+    // Parsed messages of one feed, waiting to be stored.
+    struct StoreJob {
+      Feed* m_feed;
+      MessageBatch m_batch;
+    };
+
+    void loadConcurrencyLimits();
+    void adjustConcurrency(qint64 latency, bool error_during_obtaining);
     void updateAvailableFeeds();
+    void oneFeedFetched(Feed* feed, const FetchResult& result);
+    void releaseRunningFeed(const Feed* feed, bool error_during_obtaining);
+    void updateHostHealth(const QString& host, const FetchResult& result, qint64 retry_after);
+    bool isHostBlocked(const QString& host) const;
+    void storeQueuedMessages();
+    void feedProcessed(Feed* feed, int updated_messages);
     void finalizeUpdate();
 
+    static QString hostOfFeed(const Feed* feed);
+
+    // Returns delay in msecs requested by the server via "Retry-After"
+    // header (or HTTP code 429), 0 if there is no such request.
+    static qint64 retryAfter(const FetchResult& result);
+
     QList<Feed*> m_feeds;
+
+    // Custom IDs of feeds of this update keyed by their account ID.
+    QHash<int, QStringList> m_feedsOfAccounts;
     QMutex* m_mutex;
     QThreadPool* m_threadPool;
+    FetchEngine* m_fetchEngine;
+    CancellationToken* m_cancellationToken;
+
+    // Whole update gets stopped if it does not finish in time.
+    QTimer* m_deadlineTimer;
     FeedDownloadResults m_results;
     int m_feedsUpdated;
     int m_feedsUpdating;
     int m_feedsOriginalCount;
+
+    // Concurrency limits of downloads. "m_concurrency" is adaptive and it
+    // moves between 1 and "m_maxConcurrency" according to latencies
+    // and errors of finished downloads.
+    int m_maxConcurrency;
+    int m_maxConcurrencyPerHost;
+    int m_concurrency;
+    double m_averageLatency;
+    double m_errorRate;
+    QElapsedTimer m_updateTimer;
+    QHash<QString, int> m_runningPerHost;
+    QHash<const Feed*, RunningFeed> m_runningFeeds;
+
+    // Health of hosts is remembered across updates, "m_retryAfter"
+    // holds delays requested by servers for feeds which are being parsed.
+    QHash<QString, HostHealth> m_hostHealth;
+    QHash<const Feed*, qint64> m_retryAfter;
+
+    // Feeds which are parsed and wait for DB writer.
+    // NOTE: Jobs are move-only, thus they cannot be stored in QList.
+    std::vector<StoreJob> m_storeQueue;
+    int m_storeQueueMessages;
+    qint64 m_storeQueueBytes;
+    qint64 m_peakBytesInFlight;
+    QTimer* m_storeTimer;
 };
 
 #endif // FEEDDOWNLOADER_H
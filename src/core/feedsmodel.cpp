@@ -5,6 +5,7 @@
 #include "definitions/definitions.h"
 #include "gui/dialogs/formmain.h"
 #include "miscellaneous/databasefactory.h"
+#include "miscellaneous/databasequeries.h"
 #include "miscellaneous/feedreader.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/textfactory.h"
@@ -16,6 +17,7 @@
 #include "services/standard/standardserviceentrypoint.h"
 #include "services/standard/standardserviceroot.h"
 
+#include <QDateTime>
 #include <QMimeData>
 #include <QPair>
 #include <QSqlError>
@@ -323,10 +325,17 @@ StandardServiceRoot* FeedsModel::standardServiceRoot() const {
   return nullptr;
 }
 
-QList<Feed*>FeedsModel::feedsForScheduledUpdate(bool auto_update_now) {
+QList<Feed*>FeedsModel::feedsForScheduledUpdate(bool auto_update_now, bool adaptive_update) {
   QList<Feed*>feeds_for_update;
 
   foreach (Feed* feed, m_rootItem->getSubTreeFeeds()) {
+    int interval;
+
+    if (feed->isBackingOff()) {
+      // Feed keeps failing, let it (and its server) rest for a while.
+      continue;
+    }
+
     switch (feed->autoUpdateType()) {
       case Feed::DontAutoUpdate:
 
@@ -335,35 +344,110 @@ QList<Feed*>FeedsModel::feedsForScheduledUpdate(bool auto_update_now) {
 
       case Feed::DefaultAutoUpdate:
 
-        if (auto_update_now) {
-          feeds_for_update.append(feed);
+        if (!adaptive_update) {
+          if (auto_update_now) {
+            feeds_for_update.append(feed);
+          }
+
+          continue;
         }
 
+        // Feed is scheduled according to its own publishing rate.
+        interval = feed->adaptiveUpdateInterval();
         break;
 
       case Feed::SpecificAutoUpdate:
       default:
-        int remaining_interval = feed->autoUpdateRemainingInterval();
+        interval = feed->autoUpdateInitialInterval();
+        break;
+    }
 
-        if (--remaining_interval <= 0) {
-          // Interval of this feed passed, include this feed in the output list
-          // and reset the interval.
-          feeds_for_update.append(feed);
-          feed->setAutoUpdateRemainingInterval(feed->autoUpdateInitialInterval());
-        }
-        else {
-          // Interval did not pass, set new decremented interval and do NOT
-          // include this feed in the output list.
-          feed->setAutoUpdateRemainingInterval(remaining_interval);
-        }
+    int remaining_interval = feed->autoUpdateRemainingInterval();
 
-        break;
+    if (--remaining_interval <= 0) {
+      // Interval of this feed passed, include this feed in the output list
+      // and reset the interval.
+      feeds_for_update.append(feed);
+      feed->setAutoUpdateRemainingInterval(interval);
+    }
+    else {
+      // Interval did not pass, set new decremented interval and do NOT
+      // include this feed in the output list.
+      feed->setAutoUpdateRemainingInterval(remaining_interval);
     }
   }
 
   return feeds_for_update;
 }
 
+void FeedsModel::updateAdaptiveUpdateIntervals(int default_interval, int min_interval, int max_interval) {
+  QSqlDatabase database = qApp->database()->readConnection();
+  const qint64 since = QDateTime::currentDateTimeUtc().toMSecsSinceEpoch() - qint64(ADAPTIVE_UPDATE_HISTORY_DAYS) * 24 * 60 * 60 * 1000;
+  QHash<int, QMap<QString, QPair<int, qint64>>> history;
+
+  foreach (ServiceRoot* service, serviceRoots()) {
+    QStringList feed_custom_ids;
+    bool ok;
+
+    foreach (const Feed* feed, service->getSubTreeFeeds()) {
+      feed_custom_ids.append(feed->customId());
+    }
+
+    const QMap<QString, QPair<int, qint64>> service_history = DatabaseQueries::getPublishingHistoryForFeeds(database,
+                                                                                                            service->accountId(),
+                                                                                                            feed_custom_ids,
+                                                                                                            since,
+                                                                                                            &ok);
+
+    if (ok) {
+      history.insert(service->accountId(), service_history);
+    }
+    else {
+      qWarning("Failed to obtain publishing history of feeds of account %d.", service->accountId());
+    }
+  }
+
+  updateAdaptiveUpdateIntervals(history, default_interval, min_interval, max_interval);
+}
+
+void FeedsModel::updateAdaptiveUpdateIntervals(const QHash<int, QMap<QString, QPair<int, qint64>>>& history,
+                                               int default_interval, int min_interval, int max_interval) {
+  const qint64 now = QDateTime::currentDateTimeUtc().toMSecsSinceEpoch();
+  const qint64 history_length = qint64(ADAPTIVE_UPDATE_HISTORY_DAYS) * 24 * 60 * 60 * 1000;
+
+  foreach (ServiceRoot* service, serviceRoots()) {
+    if (!history.contains(service->accountId())) {
+      continue;
+    }
+
+    const QMap<QString, QPair<int, qint64>> service_history = history.value(service->accountId());
+
+    foreach (Feed* feed, service->getSubTreeFeeds()) {
+      if (!service_history.contains(feed->customId())) {
+        // History of this feed was not evaluated, its interval stays as it is.
+        continue;
+      }
+
+      const QPair<int, qint64> feed_history = service_history.value(feed->customId());
+
+      if (feed_history.second <= 0) {
+        // We know nothing about this feed yet.
+        feed->setAdaptiveUpdateInterval(default_interval);
+        continue;
+      }
+
+      // Expected gap between two messages is given by recent publishing rate and it
+      // is prolonged if the feed is silent for longer than that. We check the feed
+      // twice per expected gap.
+      const qint64 average_gap = feed_history.first > 0 ? history_length / feed_history.first : history_length;
+      const qint64 expected_gap = qMax(average_gap, now - feed_history.second);
+      const int interval = int(qBound(qint64(min_interval), expected_gap / 2 / 60000, qint64(max_interval)));
+
+      feed->setAdaptiveUpdateInterval(interval);
+    }
+  }
+}
+
 QList<Message>FeedsModel::messagesForItem(RootItem* item) const {
   return item->undeletedMessages();
 }
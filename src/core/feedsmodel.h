@@ -7,6 +7,10 @@
 
 #include "services/abstract/rootitem.h"
 
+#include <QHash>
+#include <QMap>
+#include <QPair>
+
 class Category;
 class Feed;
 class ServiceRoot;
@@ -58,9 +62,22 @@ class FeedsModel : public QAbstractItemModel {
     // Variable "auto_update_now" is true, when global timeout
     // for scheduled auto-update was met and global auto-update strategy is enabled
     // so feeds with "default" auto-update strategy should be updated.
+    // If "adaptive_update" is true, then feeds with "default" auto-update
+    // strategy are scheduled according to their own adaptive intervals instead.
+    // Feeds which back off after repeated failures are never returned.
     //
     // This method might change some properties of some feeds.
-    QList<Feed*> feedsForScheduledUpdate(bool auto_update_now);
+    QList<Feed*> feedsForScheduledUpdate(bool auto_update_now, bool adaptive_update);
+
+    // Estimates adaptive auto-update intervals of all feeds from dates of their
+    // messages. Feeds without any messages get "default_interval".
+    void updateAdaptiveUpdateIntervals(int default_interval, int min_interval, int max_interval);
+
+    // Same as above, but publishing history of feeds is already obtained, see
+    // DatabaseQueries::getPublishingHistoryForFeeds(). Intervals of feeds which
+    // are not in "history" (keyed by account ID) are not changed.
+    void updateAdaptiveUpdateIntervals(const QHash<int, QMap<QString, QPair<int, qint64>>>& history,
+                                       int default_interval, int min_interval, int max_interval);
 
     // Returns (undeleted) messages for given feeds.
     // This is usually used for displaying whole feeds
@@ -2,6 +2,7 @@
 
 #include "core/message.h"
 
+#include "miscellaneous/stringpool.h"
 #include "miscellaneous/textfactory.h"
 
 #include <QVariant>
@@ -51,10 +52,10 @@ Message::Message() {
   m_title = m_url = m_author = m_contents = m_feedId = m_customId = m_customHash = QSL("");
   m_enclosures = QList<Enclosure>();
   m_accountId = m_id = 0;
-  m_isRead = m_isImportant = false;
+  m_isRead = m_isImportant = m_createdFromFeed = false;
 }
 
-Message Message::fromSqlRecord(const QSqlRecord& record, bool* result) {
+Message Message::fromSqlRecord(const QSqlRecord& record, bool* result, StringPool* pool) {
   if (record.count() != MSG_DB_HAS_ENCLOSURES + 1) {
     if (result != nullptr) {
       *result = false;
@@ -79,6 +80,10 @@ Message Message::fromSqlRecord(const QSqlRecord& record, bool* result) {
   message.m_customId = record.value(MSG_DB_CUSTOM_ID_INDEX).toString();
   message.m_customHash = record.value(MSG_DB_CUSTOM_HASH_INDEX).toString();
 
+  if (pool != nullptr) {
+    message.internStrings(*pool);
+  }
+
   if (result != nullptr) {
     *result = true;
   }
@@ -86,6 +91,46 @@ Message Message::fromSqlRecord(const QSqlRecord& record, bool* result) {
   return message;
 }
 
+void Message::internStrings(StringPool& pool) {
+  pool.internInPlace(m_feedId);
+  pool.internInPlace(m_author);
+  pool.internInPlace(m_customHash);
+
+  for (int i = 0; i < m_enclosures.size(); i++) {
+    if (!m_enclosures.at(i).m_mimeType.isEmpty()) {
+      pool.internInPlace(m_enclosures[i].m_mimeType);
+    }
+  }
+}
+
+quint64 Message::identityHash() const {
+  // Whitespace in title/author and scheme of URL often change when
+  // the feed is republished, they do not make message different.
+  QString url = m_url.trimmed();
+
+  if (url.startsWith(QL1S("https://"), Qt::CaseInsensitive)) {
+    url = url.mid(8);
+  }
+  else if (url.startsWith(QL1S("http://"), Qt::CaseInsensitive)) {
+    url = url.mid(7);
+  }
+
+  while (url.endsWith(QL1C('/'))) {
+    url.chop(1);
+  }
+
+  QByteArray identity;
+
+  foreach (const QString& part, QStringList() << m_title.simplified() << url << m_author.simplified()) {
+    const QByteArray part_data = part.toUtf8();
+
+    // Parts are prefixed with their lengths so that their boundaries are unambiguous.
+    identity += QByteArray::number(part_data.size()) + ':' + part_data;
+  }
+
+  return TextFactory::hash64(identity);
+}
+
 QDataStream& operator<<(QDataStream& out, const Message& myObj) {
   out << myObj.m_accountId
       << myObj.m_customHash
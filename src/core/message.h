@@ -10,6 +10,8 @@
 #include <QSqlRecord>
 #include <QStringList>
 
+class StringPool;
+
 // Represents single enclosure.
 struct Enclosure {
   public:
@@ -33,22 +35,33 @@ class Message {
 
     // Creates Message from given record, which contains
     // row from query SELECT * FROM Messages WHERE ....;
-    static Message fromSqlRecord(const QSqlRecord& record, bool* result = nullptr);
+    // Repeated values of "feed", "author", "custom_hash" and MIME types
+    // of enclosures are interned in "pool" if it is given.
+    static Message fromSqlRecord(const QSqlRecord& record, bool* result = nullptr, StringPool* pool = nullptr);
+
+    // Makes fields which usually repeat across many messages share their data
+    // with equal values already present in the pool.
+    void internStrings(StringPool& pool);
+
+    // Returns hash of normalized title, URL and author, which identifies
+    // message without custom ID within its feed.
+    quint64 identityHash() const;
+
+    // NOTE: Members are ordered by size to avoid padding.
     QString m_title;
     QString m_url;
     QString m_author;
     QString m_contents;
-    QDateTime m_created;
     QString m_feedId;
-    int m_accountId;
-    int m_id;
     QString m_customId;
     QString m_customHash;
+    QDateTime m_created;
+    QList<Enclosure> m_enclosures;
+    int m_accountId;
+    int m_id;
     bool m_isRead;
     bool m_isImportant;
 
-    QList<Enclosure> m_enclosures;
-
     // Is true if "created" date was obtained directly
     // from the feed, otherwise is false
     bool m_createdFromFeed;
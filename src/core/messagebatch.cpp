@@ -0,0 +1,93 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#include "core/messagebatch.h"
+
+#include <utility>
+
+QAtomicInteger<qint64> MessageBatch::s_bytesInFlight(0);
+
+MessageBatch::MessageBatch(QList<Message> messages, bool error_during_obtaining)
+  : m_messages(std::move(messages)), m_errorDuringObtaining(error_during_obtaining), m_sizeInBytes(0) {
+  for (int i = 0; i < m_messages.size(); i++) {
+    m_sizeInBytes += estimateSize(m_messages.at(i));
+  }
+
+  s_bytesInFlight.fetchAndAddRelaxed(m_sizeInBytes);
+}
+
+MessageBatch::MessageBatch(MessageBatch&& other) Q_DECL_NOEXCEPT
+  : m_messages(std::move(other.m_messages)), m_errorDuringObtaining(other.m_errorDuringObtaining),
+  m_sizeInBytes(other.m_sizeInBytes) {
+  other.m_messages.clear();
+  other.m_sizeInBytes = 0;
+}
+
+MessageBatch& MessageBatch::operator=(MessageBatch&& other) Q_DECL_NOEXCEPT {
+  if (this != &other) {
+    release();
+
+    m_messages = std::move(other.m_messages);
+    m_errorDuringObtaining = other.m_errorDuringObtaining;
+    m_sizeInBytes = other.m_sizeInBytes;
+    other.m_messages.clear();
+    other.m_sizeInBytes = 0;
+  }
+
+  return *this;
+}
+
+MessageBatch::~MessageBatch() {
+  release();
+}
+
+QList<Message>& MessageBatch::messages() {
+  return m_messages;
+}
+
+const QList<Message>& MessageBatch::messages() const {
+  return m_messages;
+}
+
+int MessageBatch::size() const {
+  return m_messages.size();
+}
+
+bool MessageBatch::isEmpty() const {
+  return m_messages.isEmpty();
+}
+
+bool MessageBatch::errorDuringObtaining() const {
+  return m_errorDuringObtaining;
+}
+
+qint64 MessageBatch::sizeInBytes() const {
+  return m_sizeInBytes;
+}
+
+qint64 MessageBatch::bytesInFlight() {
+  return s_bytesInFlight.loadAcquire();
+}
+
+qint64 MessageBatch::estimateSize(const Message& message) {
+  qint64 size = sizeof(Message);
+  const int characters = message.m_title.size() + message.m_url.size() + message.m_author.size() +
+                         message.m_contents.size() + message.m_feedId.size() + message.m_customId.size() +
+                         message.m_customHash.size();
+
+  size += qint64(characters) * qint64(sizeof(QChar));
+
+  foreach (const Enclosure& enclosure, message.m_enclosures) {
+    size += sizeof(Enclosure) + qint64(enclosure.m_url.size() + enclosure.m_mimeType.size()) * qint64(sizeof(QChar));
+  }
+
+  return size;
+}
+
+void MessageBatch::release() {
+  if (m_sizeInBytes > 0) {
+    s_bytesInFlight.fetchAndAddRelaxed(-m_sizeInBytes);
+    m_sizeInBytes = 0;
+  }
+
+  m_messages.clear();
+}
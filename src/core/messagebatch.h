@@ -0,0 +1,55 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#ifndef MESSAGEBATCH_H
+#define MESSAGEBATCH_H
+
+#include "core/message.h"
+
+#include <QAtomicInteger>
+#include <QList>
+
+// Messages obtained by single feed update. Batch can be moved but not
+// copied, so messages are handed over from parser threads to DB writer
+// without any copies of the list or of messages themselves.
+//
+// Approximate memory held by all living batches is tracked, so that we
+// know how much data is in flight during big updates.
+class MessageBatch {
+  public:
+    explicit MessageBatch(QList<Message> messages = QList<Message>(), bool error_during_obtaining = false);
+    MessageBatch(MessageBatch&& other) Q_DECL_NOEXCEPT;
+    MessageBatch& operator=(MessageBatch&& other) Q_DECL_NOEXCEPT;
+    virtual ~MessageBatch();
+
+    // NOTE: Modify messages only via this reference and
+    // do not keep copies of the list, it would detach.
+    QList<Message>& messages();
+    const QList<Message>& messages() const;
+
+    int size() const;
+    bool isEmpty() const;
+    bool errorDuringObtaining() const;
+
+    // Approximate count of bytes held by messages of this batch.
+    qint64 sizeInBytes() const;
+
+    // Approximate count of bytes held by all batches.
+    static qint64 bytesInFlight();
+
+    // Approximate count of bytes held by single message, data of strings
+    // shared among messages are counted for each message.
+    static qint64 estimateSize(const Message& message);
+
+  private:
+    Q_DISABLE_COPY(MessageBatch)
+
+    void release();
+
+    QList<Message> m_messages;
+    bool m_errorDuringObtaining;
+    qint64 m_sizeInBytes;
+
+    static QAtomicInteger<qint64> s_bytesInFlight;
+};
+
+#endif // MESSAGEBATCH_H
@@ -0,0 +1,204 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#include "core/messagesanitizer.h"
+
+#include "definitions/definitions.h"
+
+MessageSanitizer::MessageSanitizer() {}
+
+void MessageSanitizer::sanitize(Message& message) {
+  decodePercentEncoding(message.m_contents);
+  sanitizeTitle(message.m_title);
+  sanitizeUrl(message.m_url);
+}
+
+void MessageSanitizer::decodePercentEncoding(QString& text) {
+  const int size = text.size();
+  int position = text.indexOf(QL1C('%'));
+
+  if (position < 0) {
+    return;
+  }
+
+  QChar* data = text.data();
+  int output_position = position;
+
+  while (position < size) {
+    if (data[position] == QL1C('%')) {
+      int decoded_size;
+      const int consumed = decodePercentSequence(data, position, size, data + output_position, decoded_size);
+
+      if (consumed > 0) {
+        position += consumed;
+        output_position += decoded_size;
+        continue;
+      }
+    }
+
+    data[output_position++] = data[position++];
+  }
+
+  text.truncate(output_position);
+}
+
+void MessageSanitizer::sanitizeTitle(QString& title) {
+  decodePercentEncoding(title);
+
+  const int size = title.size();
+  int output_position = 0;
+  bool pending_space = false;
+
+  if (size == 0) {
+    return;
+  }
+
+  QChar* data = title.data();
+
+  for (int position = 0; position < size; position++) {
+    if (data[position].isSpace()) {
+      pending_space = output_position > 0;
+    }
+    else {
+      if (pending_space) {
+        data[output_position++] = QL1C(' ');
+        pending_space = false;
+      }
+
+      data[output_position++] = data[position];
+    }
+  }
+
+  title.truncate(output_position);
+}
+
+void MessageSanitizer::sanitizeUrl(QString& url) {
+  const int size = url.size();
+  int start = 0, end = size;
+
+  while (start < end && url.at(start).isSpace()) {
+    start++;
+  }
+
+  while (end > start && url.at(end - 1).isSpace()) {
+    end--;
+  }
+
+  if (start == 0 && end == size && url.indexOf(QL1C('\t')) < 0 && url.indexOf(QL1C('\n')) < 0 &&
+      url.indexOf(QL1C('\r')) < 0) {
+    // URL is clean, do not detach it.
+    return;
+  }
+
+  QChar* data = url.data();
+  int output_position = 0;
+
+  for (int position = start; position < end; position++) {
+    const ushort character = data[position].unicode();
+
+    if (character != '\t' && character != '\n' && character != '\r') {
+      data[output_position++] = data[position];
+    }
+  }
+
+  url.truncate(output_position);
+}
+
+int MessageSanitizer::hexValue(ushort character) {
+  if (character >= '0' && character <= '9') {
+    return character - '0';
+  }
+  else if (character >= 'a' && character <= 'f') {
+    return character - 'a' + 10;
+  }
+  else if (character >= 'A' && character <= 'F') {
+    return character - 'A' + 10;
+  }
+  else {
+    return -1;
+  }
+}
+
+int MessageSanitizer::decodePercentSequence(const QChar* input, int position, int size, QChar* output, int& output_size) {
+  uint bytes[4];
+  int byte_count = 0, needed_bytes = 1;
+
+  while (byte_count < needed_bytes) {
+    const int index = position + byte_count * 3;
+
+    if (index + 2 >= size || input[index] != QL1C('%')) {
+      return 0;
+    }
+
+    const int high = hexValue(input[index + 1].unicode());
+    const int low = hexValue(input[index + 2].unicode());
+
+    if (high < 0 || low < 0) {
+      return 0;
+    }
+
+    const uint byte = uint(high * 16 + low);
+
+    if (byte_count == 0) {
+      if (byte < 0x80) {
+        needed_bytes = 1;
+      }
+      else if ((byte & 0xE0) == 0xC0) {
+        needed_bytes = 2;
+      }
+      else if ((byte & 0xF0) == 0xE0) {
+        needed_bytes = 3;
+      }
+      else if ((byte & 0xF8) == 0xF0) {
+        needed_bytes = 4;
+      }
+      else {
+        return 0;
+      }
+    }
+    else if ((byte & 0xC0) != 0x80) {
+      return 0;
+    }
+
+    bytes[byte_count++] = byte;
+  }
+
+  uint code_point;
+
+  switch (byte_count) {
+    case 1:
+      code_point = bytes[0];
+      break;
+
+    case 2:
+      code_point = ((bytes[0] & 0x1F) << 6) | (bytes[1] & 0x3F);
+      break;
+
+    case 3:
+      code_point = ((bytes[0] & 0x0F) << 12) | ((bytes[1] & 0x3F) << 6) | (bytes[2] & 0x3F);
+      break;
+
+    default:
+      code_point = ((bytes[0] & 0x07) << 18) | ((bytes[1] & 0x3F) << 12) | ((bytes[2] & 0x3F) << 6) | (bytes[3] & 0x3F);
+      break;
+  }
+
+  // Reject overlong encodings, surrogates and values out of Unicode range.
+  static const uint minimal_values[] = { 0, 0x80, 0x800, 0x10000 };
+
+  if (code_point < minimal_values[byte_count - 1] || code_point > 0x10FFFF ||
+      (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+    return 0;
+  }
+
+  if (QChar::requiresSurrogates(code_point)) {
+    output[0] = QChar(QChar::highSurrogate(code_point));
+    output[1] = QChar(QChar::lowSurrogate(code_point));
+    output_size = 2;
+  }
+  else {
+    output[0] = QChar(code_point);
+    output_size = 1;
+  }
+
+  return byte_count * 3;
+}
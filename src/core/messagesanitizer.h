@@ -0,0 +1,45 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#ifndef MESSAGESANITIZER_H
+#define MESSAGESANITIZER_H
+
+#include "core/message.h"
+
+#include <QString>
+
+// Normalizes fields of downloaded messages before they are stored.
+// Each field is processed in a single linear scan and rewritten in place,
+// so no memory is allocated unless the string is shared.
+class MessageSanitizer {
+  private:
+
+    // Constructors and destructors.
+    MessageSanitizer();
+
+  public:
+
+    // Sanitizes all fields of the message.
+    static void sanitize(Message& message);
+
+    // Decodes percent-encoded UTF-8 sequences. Invalid
+    // sequences are kept as they are.
+    static void decodePercentEncoding(QString& text);
+
+    // Decodes percent-encoding, collapses white space into single
+    // spaces and removes leading and trailing white space.
+    static void sanitizeTitle(QString& title);
+
+    // Removes tabs and line breaks, which often get into URLs
+    // from pretty-printed XML, and surrounding white space.
+    static void sanitizeUrl(QString& url);
+
+  private:
+    static int hexValue(ushort character);
+
+    // Tries to decode percent-encoded UTF-8 sequence starting at "position",
+    // writes decoded characters to "output" and returns count of consumed
+    // characters or 0 if sequence is not valid.
+    static int decodePercentSequence(const QChar* input, int position, int size, QChar* output, int& output_size);
+};
+
+#endif // MESSAGESANITIZER_H
@@ -17,7 +17,8 @@
 
 MessagesModel::MessagesModel(QObject* parent)
   : QSqlQueryModel(parent), MessagesModelSqlLayer(),
-  m_cache(new MessagesModelCache(this)), m_messageHighlighter(NoHighlighting), m_customDateFormat(QString()), m_itemHeight(-1) {
+  m_cache(new MessagesModelCache(this)), m_messageHighlighter(NoHighlighting), m_customDateFormat(QString()), m_stringPool(StringPool()),
+  m_itemHeight(-1) {
   setupFonts();
   setupIcons();
   setupHeaderData();
@@ -50,7 +51,9 @@ void MessagesModel::updateItemHeight() {
 
 void MessagesModel::repopulate() {
   m_cache->clear();
-  setQuery(selectStatement(), m_db);
+  m_stringPool.clear();
+  // Messages are read via read-only connection, which is not blocked by running feed update.
+  setQuery(selectStatement(), qApp->database()->readConnection());
 
   if (lastError().isValid()) {
     qCritical() << "Error when setting new msg view query:" << lastError().text();
@@ -149,7 +152,8 @@ void MessagesModel::reloadWholeLayout() {
 }
 
 Message MessagesModel::messageAt(int row_index) const {
-  return Message::fromSqlRecord(m_cache->containsData(row_index) ? m_cache->record(row_index) : record(row_index));
+  return Message::fromSqlRecord(m_cache->containsData(row_index) ? m_cache->record(row_index) : record(row_index),
+                                nullptr, &m_stringPool);
 }
 
 void MessagesModel::setupHeaderData() {
@@ -8,6 +8,7 @@
 
 #include "core/message.h"
 #include "definitions/definitions.h"
+#include "miscellaneous/stringpool.h"
 #include "services/abstract/rootitem.h"
 
 #include <QFont>
@@ -85,6 +86,9 @@ class MessagesModel : public QSqlQueryModel, public MessagesModelSqlLayer {
     MessagesModelCache* m_cache;
     MessageHighlighter m_messageHighlighter;
     QString m_customDateFormat;
+
+    // Shares repeated values among messages created by messageAt().
+    mutable StringPool m_stringPool;
     RootItem* m_selectedItem;
 
     QList<QString> m_headerData;
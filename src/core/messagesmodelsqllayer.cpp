@@ -87,9 +87,13 @@ QString MessagesModelSqlLayer::formatFields() const {
 }
 
 QString MessagesModelSqlLayer::selectStatement() const {
-  return QL1S("SELECT ") + formatFields() +
+  return selectStatement(formatFields(), m_filter, orderByClause());
+}
+
+QString MessagesModelSqlLayer::selectStatement(const QString& fields, const QString& filter, const QString& order_by) {
+  return QL1S("SELECT ") + fields +
          QSL(" FROM Messages LEFT JOIN Feeds ON Messages.feed = Feeds.custom_id AND Messages.account_id = Feeds.account_id WHERE ") +
-         m_filter + orderByClause() + QL1C(';');
+         filter + order_by + QL1C(';');
 }
 
 QString MessagesModelSqlLayer::orderByClause() const {
@@ -18,6 +18,10 @@ class MessagesModelSqlLayer {
     // Sets SQL WHERE clause, without "WHERE" keyword.
     void setFilter(const QString& filter);
 
+    // Returns statement which selects given fields of messages
+    // matching the filter, fields of their feeds are available too.
+    static QString selectStatement(const QString& fields, const QString& filter, const QString& order_by = QString());
+
   protected:
     QString orderByClause() const;
     QString selectStatement() const;
@@ -43,14 +43,33 @@
 #define TRAY_ICON_BUBBLE_TIMEOUT              20000
 #define CLOSE_LOCK_TIMEOUT                    500
 #define DOWNLOAD_TIMEOUT                      30000
+#define CONTENT_DECODER_BUFFER_SIZE           16384
+#define FEED_SNIFFER_MAX_SIZE                 65536
+#define DATABASE_BULK_CHUNK_SIZE              500
+#define DATABASE_BULK_INSERT_ROWS             50
 #define MESSAGES_VIEW_DEFAULT_COL             170
 #define MESSAGES_VIEW_MINIMUM_COL             16
 #define FEEDS_VIEW_COLUMN_COUNT               2
-#define FEED_DOWNLOADER_MAX_THREADS           3
+#define FEED_DOWNLOADER_MAX_THREADS           32
+#define FEED_DOWNLOADER_MAX_CONNECTIONS       256
+#define FEED_DOWNLOADER_SLOW_RESPONSE         5000
+#define FEED_DOWNLOADER_STORE_BATCH           32
+#define FEED_DOWNLOADER_STORE_BATCH_MESSAGES  5000
+#define FEED_DOWNLOADER_STORE_BATCH_BYTES     33554432
+#define FEED_DOWNLOADER_STORE_DELAY           1000
+#define FEED_DOWNLOADER_UPDATE_DEADLINE       1800000
+#define FEED_BACKOFF_BASE_INTERVAL            5
+#define FEED_BACKOFF_MAX_INTERVAL             1440
+#define FEED_CIRCUIT_BREAKER_FAILURES         5
+#define HOST_CIRCUIT_BREAKER_FAILURES         3
+#define DEFAULT_CONCURRENT_UPDATES            8
+#define DEFAULT_CONCURRENT_HOST_UPDATES       2
 #define DEFAULT_DAYS_TO_DELETE_MSG            14
 #define ELLIPSIS_LENGTH                       3
 #define MIN_CATEGORY_NAME_LENGTH              1
 #define DEFAULT_AUTO_UPDATE_INTERVAL          15
+#define DEFAULT_ADAPTIVE_UPDATE_MAX_INTERVAL  1440
+#define ADAPTIVE_UPDATE_HISTORY_DAYS          30
 #define AUTO_UPDATE_INTERVAL                  60000
 #define STARTUP_UPDATE_DELAY                  30000
 #define TIMEZONE_OFFSET_LIMIT                 6
@@ -77,6 +96,16 @@
 #define HTTP_HEADERS_CONTENT_TYPE   "Content-Type"
 #define HTTP_HEADERS_AUTHORIZATION  "Authorization"
 #define HTTP_HEADERS_USER_AGENT     "User-Agent"
+#define HTTP_HEADERS_ACCEPT_ENCODING  "Accept-Encoding"
+#define HTTP_HEADERS_CONTENT_ENCODING "Content-Encoding"
+#define HTTP_HEADERS_ETAG           "ETag"
+#define HTTP_HEADERS_LAST_MODIFIED  "Last-Modified"
+#define HTTP_HEADERS_IF_NONE_MATCH  "If-None-Match"
+#define HTTP_HEADERS_IF_MOD_SINCE   "If-Modified-Since"
+#define HTTP_HEADERS_RETRY_AFTER    "Retry-After"
+#define HTTP_CODE_NOT_MODIFIED      304
+#define HTTP_CODE_TOO_MANY_REQUESTS 429
+#define HTTP_CODE_SERVICE_UNAVAILABLE 503
 
 #define MAX_ZOOM_FACTOR     5.0f
 #define MIN_ZOOM_FACTOR     0.25f
@@ -112,8 +141,13 @@
 #define APP_DB_SQLITE_PATH            "database/local"
 #define APP_DB_SQLITE_FILE            "database.db"
 
+// Connection used by feed updates for storing messages and
+// prefix of read-only connections, one per thread.
+#define APP_DB_WRITER_CONNECTION      "feed_upd"
+#define APP_DB_READER_PREFIX          "reader_"
+
 // Keep this in sync with schema versions declared in SQL initialization code.
-#define APP_DB_SCHEMA_VERSION         "11"
+#define APP_DB_SCHEMA_VERSION         "12"
 #define APP_DB_UPDATE_FILE_PATTERN    "db_update_%1_%2_%3.sql"
 #define APP_DB_COMMENT_SPLIT          "-- !\n"
 #define APP_DB_NAME_PLACEHOLDER       "##"
@@ -200,6 +234,9 @@
 #define FDS_DB_TYPE_INDEX             13
 #define FDS_DB_ACCOUNT_ID_INDEX       14
 #define FDS_DB_CUSTOM_ID_INDEX        15
+#define FDS_DB_HTTP_ETAG_INDEX        16
+#define FDS_DB_HTTP_LASTMOD_INDEX     17
+#define FDS_DB_CONTENT_HASH_INDEX     18
 
 // Indexes of columns for feed models.
 #define FDS_MODEL_TITLE_INDEX           0
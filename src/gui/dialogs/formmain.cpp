@@ -369,11 +369,13 @@ void FormMain::onFeedUpdatesStarted() {
   statusBar()->showProgressFeeds(0, tr("Feed update started"));
 }
 
-void FormMain::onFeedUpdatesProgress(const Feed* feed, int current, int total) {
+void FormMain::onFeedUpdatesProgress(const Feed* feed, int current, int total, int running, int capacity) {
   statusBar()->showProgressFeeds((current * 100.0) / total,
 
                                  //: Text display in status bar when particular feed is updated.
-                                 tr("Updated feed '%1'").arg(feed->title()));
+                                 tr("Updated feed '%1' (%2/%3 downloads running)").arg(feed->title(),
+                                                                                       QString::number(running),
+                                                                                       QString::number(capacity)));
 }
 
 void FormMain::updateMessageButtonsAvailability() {
@@ -62,7 +62,7 @@ class FormMain : public QMainWindow {
     void updateFeedButtonsAvailability();
 
     void onFeedUpdatesStarted();
-    void onFeedUpdatesProgress(const Feed* feed, int current, int total);
+    void onFeedUpdatesProgress(const Feed* feed, int current, int total, int running, int capacity);
     void onFeedUpdatesFinished(const FeedDownloadResults& results);
 
     // Displays various dialogs.
@@ -226,7 +226,7 @@ void SettingsBrowserMail::saveSettings() {
   ExternalTool::setToolsToSettings(tools);
 
   // Reload settings for all network access managers.
-  SilentNetworkAccessManager::instance()->loadSettings();
+  SilentNetworkAccessManager::reloadSettingsOfAllInstances();
   onEndSaveSettings();
 }
 
@@ -43,8 +43,18 @@ SettingsFeedsMessages::SettingsFeedsMessages(Settings* settings, QWidget* parent
   connect(m_ui->m_spinHeightRowsFeeds, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
           this, &SettingsFeedsMessages::dirtifySettings);
   connect(m_ui->m_checkAutoUpdate, &QCheckBox::toggled, m_ui->m_spinAutoUpdateInterval, &TimeSpinBox::setEnabled);
+  connect(m_ui->m_checkAutoUpdate, &QCheckBox::toggled, m_ui->m_checkAdaptiveAutoUpdate, &QCheckBox::setEnabled);
+  connect(m_ui->m_checkAdaptiveAutoUpdate, &QCheckBox::toggled, this, &SettingsFeedsMessages::dirtifySettings);
+  connect(m_ui->m_spinAdaptiveMinInterval, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+          this, &SettingsFeedsMessages::dirtifySettings);
+  connect(m_ui->m_spinAdaptiveMaxInterval, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+          this, &SettingsFeedsMessages::dirtifySettings);
   connect(m_ui->m_spinFeedUpdateTimeout, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
           &SettingsFeedsMessages::dirtifySettings);
+  connect(m_ui->m_spinMaxConcurrentUpdates, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+          &SettingsFeedsMessages::dirtifySettings);
+  connect(m_ui->m_spinMaxConcurrentUpdatesPerHost, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+          &SettingsFeedsMessages::dirtifySettings);
   connect(m_ui->m_cmbMessagesDateTimeFormat, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
           &SettingsFeedsMessages::dirtifySettings);
   connect(m_ui->m_cmbCountsFeedList, &QComboBox::currentTextChanged, this, &SettingsFeedsMessages::dirtifySettings);
@@ -104,7 +114,13 @@ void SettingsFeedsMessages::loadSettings() {
   m_ui->m_checkRemoveReadMessagesOnExit->setChecked(settings()->value(GROUP(Messages), SETTING(Messages::ClearReadOnExit)).toBool());
   m_ui->m_checkAutoUpdate->setChecked(settings()->value(GROUP(Feeds), SETTING(Feeds::AutoUpdateEnabled)).toBool());
   m_ui->m_spinAutoUpdateInterval->setValue(settings()->value(GROUP(Feeds), SETTING(Feeds::AutoUpdateInterval)).toInt());
+  m_ui->m_checkAdaptiveAutoUpdate->setChecked(settings()->value(GROUP(Feeds), SETTING(Feeds::AdaptiveAutoUpdate)).toBool());
+  m_ui->m_checkAdaptiveAutoUpdate->setEnabled(m_ui->m_checkAutoUpdate->isChecked());
+  m_ui->m_spinAdaptiveMinInterval->setValue(settings()->value(GROUP(Feeds), SETTING(Feeds::AdaptiveAutoUpdateMinInterval)).toInt());
+  m_ui->m_spinAdaptiveMaxInterval->setValue(settings()->value(GROUP(Feeds), SETTING(Feeds::AdaptiveAutoUpdateMaxInterval)).toInt());
   m_ui->m_spinFeedUpdateTimeout->setValue(settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt());
+  m_ui->m_spinMaxConcurrentUpdates->setValue(settings()->value(GROUP(Feeds), SETTING(Feeds::MaxConcurrentUpdates)).toInt());
+  m_ui->m_spinMaxConcurrentUpdatesPerHost->setValue(settings()->value(GROUP(Feeds), SETTING(Feeds::MaxConcurrentUpdatesPerHost)).toInt());
   m_ui->m_checkUpdateAllFeedsOnStartup->setChecked(settings()->value(GROUP(Feeds), SETTING(Feeds::FeedsUpdateOnStartup)).toBool());
   m_ui->m_cmbCountsFeedList->addItems(QStringList() << "(%unread)" << "[%unread]" << "%unread/%all" << "%unread-%all" << "[%unread|%all]");
   m_ui->m_cmbCountsFeedList->setEditText(settings()->value(GROUP(Feeds), SETTING(Feeds::CountFormat)).toString());
@@ -138,7 +154,12 @@ void SettingsFeedsMessages::saveSettings() {
   settings()->setValue(GROUP(Messages), Messages::ClearReadOnExit, m_ui->m_checkRemoveReadMessagesOnExit->isChecked());
   settings()->setValue(GROUP(Feeds), Feeds::AutoUpdateEnabled, m_ui->m_checkAutoUpdate->isChecked());
   settings()->setValue(GROUP(Feeds), Feeds::AutoUpdateInterval, m_ui->m_spinAutoUpdateInterval->value());
+  settings()->setValue(GROUP(Feeds), Feeds::AdaptiveAutoUpdate, m_ui->m_checkAdaptiveAutoUpdate->isChecked());
+  settings()->setValue(GROUP(Feeds), Feeds::AdaptiveAutoUpdateMinInterval, m_ui->m_spinAdaptiveMinInterval->value());
+  settings()->setValue(GROUP(Feeds), Feeds::AdaptiveAutoUpdateMaxInterval, m_ui->m_spinAdaptiveMaxInterval->value());
   settings()->setValue(GROUP(Feeds), Feeds::UpdateTimeout, m_ui->m_spinFeedUpdateTimeout->value());
+  settings()->setValue(GROUP(Feeds), Feeds::MaxConcurrentUpdates, m_ui->m_spinMaxConcurrentUpdates->value());
+  settings()->setValue(GROUP(Feeds), Feeds::MaxConcurrentUpdatesPerHost, m_ui->m_spinMaxConcurrentUpdatesPerHost->value());
   settings()->setValue(GROUP(Feeds), Feeds::FeedsUpdateOnStartup, m_ui->m_checkUpdateAllFeedsOnStartup->isChecked());
   settings()->setValue(GROUP(Feeds), Feeds::CountFormat, m_ui->m_cmbCountsFeedList->currentText());
   settings()->setValue(GROUP(Messages), Messages::UseCustomDate, m_ui->m_checkMessagesDateTimeFormat->isChecked());
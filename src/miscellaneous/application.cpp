@@ -427,10 +427,12 @@ void Application::downloadRequested(QWebEngineDownloadItem* download_item) {
 
 void Application::onFeedUpdatesStarted() {}
 
-void Application::onFeedUpdatesProgress(const Feed* feed, int current, int total) {
+void Application::onFeedUpdatesProgress(const Feed* feed, int current, int total, int running, int capacity) {
   Q_UNUSED(feed)
   Q_UNUSED(current)
   Q_UNUSED(total)
+  Q_UNUSED(running)
+  Q_UNUSED(capacity)
 }
 
 void Application::onFeedUpdatesFinished(FeedDownloadResults results) {
@@ -135,7 +135,7 @@ class Application : public QtSingleApplication {
 #endif
 
     void onFeedUpdatesStarted();
-    void onFeedUpdatesProgress(const Feed* feed, int current, int total);
+    void onFeedUpdatesProgress(const Feed* feed, int current, int total, int running, int capacity);
     void onFeedUpdatesFinished(FeedDownloadResults results);
 
   private:
@@ -0,0 +1,34 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#include "miscellaneous/cancellationtoken.h"
+
+#include <QPointer>
+#include <QThreadStorage>
+
+static QThreadStorage<QPointer<CancellationToken>> s_currentTokens;
+
+CancellationToken::CancellationToken(QObject* parent) : QObject(parent), m_cancelled(0) {}
+
+CancellationToken::~CancellationToken() {}
+
+bool CancellationToken::isCancelled() const {
+  return m_cancelled.loadAcquire() != 0;
+}
+
+CancellationToken* CancellationToken::current() {
+  return s_currentTokens.hasLocalData() ? s_currentTokens.localData().data() : nullptr;
+}
+
+void CancellationToken::setCurrent(CancellationToken* token) {
+  s_currentTokens.setLocalData(QPointer<CancellationToken>(token));
+}
+
+void CancellationToken::cancel() {
+  if (m_cancelled.testAndSetOrdered(0, 1)) {
+    emit cancelled();
+  }
+}
+
+void CancellationToken::reset() {
+  m_cancelled.storeRelease(0);
+}
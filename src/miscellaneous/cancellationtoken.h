@@ -0,0 +1,40 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <QObject>
+
+#include <QAtomicInt>
+
+// Tells long running operations (downloads, parsing) that
+// they should stop as soon as possible.
+// NOTE: Token can be cancelled from any thread.
+class CancellationToken : public QObject {
+  Q_OBJECT
+
+  public:
+    explicit CancellationToken(QObject* parent = nullptr);
+    virtual ~CancellationToken();
+
+    bool isCancelled() const;
+
+    // Token which is active in the current thread, if any. Downloaders
+    // created in the thread get aborted when the token is cancelled.
+    static CancellationToken* current();
+    static void setCurrent(CancellationToken* token);
+
+  public slots:
+    void cancel();
+    void reset();
+
+  signals:
+
+    // Emitted in the thread which cancelled the token.
+    void cancelled();
+
+  private:
+    QAtomicInt m_cancelled;
+};
+
+#endif // CANCELLATIONTOKEN_H
@@ -10,6 +10,7 @@
 #include <QDir>
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QThread>
 #include <QVariant>
 
 DatabaseFactory::DatabaseFactory(QObject* parent)
@@ -34,7 +35,7 @@ qint64 DatabaseFactory::getDatabaseFileSize() const {
 
 qint64 DatabaseFactory::getDatabaseDataSize() const {
   if (m_activeDatabaseDriver == SQLITE || m_activeDatabaseDriver == SQLITE_MEMORY) {
-    QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+    QSqlDatabase database = qApp->database()->readConnection();
     qint64 result = 1;
     QSqlQuery query(database);
 
@@ -57,7 +58,7 @@ qint64 DatabaseFactory::getDatabaseDataSize() const {
     return result;
   }
   else if (m_activeDatabaseDriver == MYSQL) {
-    QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+    QSqlDatabase database = qApp->database()->readConnection();
     qint64 result = 1;
     QSqlQuery query(database);
 
@@ -161,6 +162,10 @@ void DatabaseFactory::finishRestoration() {
   if (QFile::exists(backup_database_file)) {
     qWarning("Backup database file '%s' was detected. Restoring it.", qPrintable(QDir::toNativeSeparators(backup_database_file)));
 
+    // Journal of replaced database must not be applied to restored one.
+    QFile::remove(sqliteDatabaseFilePath() + QSL("-wal"));
+    QFile::remove(sqliteDatabaseFilePath() + QSL("-shm"));
+
     if (IOFactory::copyFile(backup_database_file, m_sqliteDatabaseFilePath + QDir::separator() + APP_DB_SQLITE_FILE)) {
       QFile::remove(backup_database_file);
       qDebug("Database file was restored successully.");
@@ -175,6 +180,28 @@ void DatabaseFactory::sqliteAssemblyDatabaseFilePath() {
   m_sqliteDatabaseFilePath = qApp->userDataFolder() + QDir::separator() + QString(APP_DB_SQLITE_PATH);
 }
 
+void DatabaseFactory::sqliteSetupFileBasedConnection(QSqlDatabase database, const QString& connection_name) {
+  QSqlQuery query_db(database);
+
+  query_db.setForwardOnly(true);
+
+  // Database file cannot get corrupted in WAL mode with "NORMAL" synchronization,
+  // only last transactions may be lost on power failure.
+  query_db.exec(QSL("PRAGMA synchronous = NORMAL"));
+  query_db.exec(QSL("PRAGMA cache_size = 16384"));
+  query_db.exec(QSL("PRAGMA count_changes = OFF"));
+  query_db.exec(QSL("PRAGMA temp_store = MEMORY"));
+
+  if (connection_name == QL1S(APP_DB_WRITER_CONNECTION)) {
+    // Commits of feed updates do not run checkpoints,
+    // feed downloader runs them after storing messages.
+    query_db.exec(QSL("PRAGMA wal_autocheckpoint = 0"));
+  }
+  else if (connection_name.startsWith(QL1S(APP_DB_READER_PREFIX))) {
+    query_db.exec(QSL("PRAGMA query_only = ON"));
+  }
+}
+
 QSqlDatabase DatabaseFactory::sqliteInitializeInMemoryDatabase() {
   QSqlDatabase database = QSqlDatabase::addDatabase(APP_DB_SQLITE_DRIVER);
 
@@ -299,12 +326,16 @@ QSqlDatabase DatabaseFactory::sqliteInitializeFileBasedDatabase(const QString& c
 
     query_db.setForwardOnly(true);
     query_db.exec(QSL("PRAGMA encoding = \"UTF-8\""));
-    query_db.exec(QSL("PRAGMA synchronous = OFF"));
-    query_db.exec(QSL("PRAGMA journal_mode = MEMORY"));
     query_db.exec(QSL("PRAGMA page_size = 4096"));
-    query_db.exec(QSL("PRAGMA cache_size = 16384"));
-    query_db.exec(QSL("PRAGMA count_changes = OFF"));
-    query_db.exec(QSL("PRAGMA temp_store = MEMORY"));
+
+    // WAL journal lets readers work while feed updates are being stored.
+    // Journal mode is persistent, it is stored in the database file.
+    if (!query_db.exec(QSL("PRAGMA journal_mode = WAL")) || !query_db.next() ||
+        query_db.value(0).toString().toLower() != QL1S("wal")) {
+      qWarning("File-based SQLite database cannot use WAL journal, readers will wait for writers.");
+    }
+
+    query_db.finish();
 
     // Sample query which checks for existence of tables.
     if (!query_db.exec(QSL("SELECT inf_value FROM Information WHERE inf_key = 'schema_version'"))) {
@@ -359,6 +390,8 @@ QSqlDatabase DatabaseFactory::sqliteInitializeFileBasedDatabase(const QString& c
              qPrintable(QDir::toNativeSeparators(database.databaseName())));
       qDebug("File-based SQLite database has version '%s'.", qPrintable(installed_db_schema));
     }
+
+    sqliteSetupFileBasedConnection(database, connection_name);
   }
 
   // Everything is initialized now.
@@ -375,6 +408,9 @@ bool DatabaseFactory::sqliteUpdateDatabaseSchema(QSqlDatabase database, const QS
   const int current_version = QString(APP_DB_SCHEMA_VERSION).remove('.').toInt();
 
   // Now, it would be good to create backup of SQLite DB file.
+  // Changes still waiting in WAL journal must be in the file first.
+  checkpointDatabase(database, true);
+
   if (IOFactory::copyFile(sqliteDatabaseFilePath(), sqliteDatabaseFilePath() + ".bak")) {
     qDebug("Creating backup of SQLite DB file.");
   }
@@ -490,6 +526,11 @@ QString DatabaseFactory::humanDriverName(const QString& driver_code) const {
   }
 }
 
+QSqlDatabase DatabaseFactory::readConnection() {
+  // Connections cannot be shared among threads, so each thread has its own reader.
+  return connection(QSL(APP_DB_READER_PREFIX) + QString::number(quintptr(QThread::currentThreadId())), FromSettings);
+}
+
 void DatabaseFactory::removeConnection(const QString& connection_name) {
   qDebug("Removing database connection '%s'.", qPrintable(connection_name));
   QSqlDatabase::removeDatabase(connection_name);
@@ -667,7 +708,7 @@ QSqlDatabase DatabaseFactory::mysqlInitializeDatabase(const QString& connection_
       query_db.next();
       const QString installed_db_schema = query_db.value(0).toString();
 
-      if (installed_db_schema < APP_DB_SCHEMA_VERSION) {
+      if (installed_db_schema.toInt() < QString(APP_DB_SCHEMA_VERSION).toInt()) {
         if (mysqlUpdateDatabaseSchema(database, installed_db_schema, database_name)) {
           qDebug("Database schema was updated from '%s' to '%s' successully or it is already up to date.",
                  qPrintable(installed_db_schema),
@@ -729,8 +770,9 @@ QSqlDatabase DatabaseFactory::sqliteConnection(const QString& connection_name, D
     }
     else {
       QSqlDatabase database;
+      const bool new_connection = !QSqlDatabase::contains(connection_name);
 
-      if (QSqlDatabase::contains(connection_name)) {
+      if (!new_connection) {
         qDebug("SQLite connection '%s' is already active.", qPrintable(connection_name));
 
         // This database connection was added previously, no need to
@@ -756,6 +798,10 @@ QSqlDatabase DatabaseFactory::sqliteConnection(const QString& connection_name, D
         qDebug("File-based SQLite database connection '%s' to file '%s' seems to be established.",
                qPrintable(connection_name),
                qPrintable(QDir::toNativeSeparators(database.databaseName())));
+
+        if (new_connection) {
+          sqliteSetupFileBasedConnection(database, connection_name);
+        }
       }
 
       return database;
@@ -786,6 +832,11 @@ void DatabaseFactory::saveDatabase() {
   switch (m_activeDatabaseDriver) {
     case SQLITE_MEMORY:
       sqliteSaveMemoryDatabase();
+      checkpointDatabase(sqliteConnection(objectName(), StrictlyFileBased), true);
+      break;
+
+    case SQLITE:
+      checkpointDatabase(sqliteConnection(objectName(), StrictlyFileBased), true);
       break;
 
     default:
@@ -806,3 +857,24 @@ bool DatabaseFactory::vacuumDatabase() {
       return false;
   }
 }
+
+void DatabaseFactory::checkpointDatabase(const QSqlDatabase& database, bool truncate) {
+  if (m_activeDatabaseDriver == MYSQL) {
+    return;
+  }
+
+  QSqlQuery query_checkpoint(database);
+
+  query_checkpoint.setForwardOnly(true);
+
+  // Result row contains "busy" flag, number of pages in journal and number of checkpointed pages.
+  if (query_checkpoint.exec(truncate ? QSL("PRAGMA wal_checkpoint(TRUNCATE)") : QSL("PRAGMA wal_checkpoint(PASSIVE)")) &&
+      query_checkpoint.next()) {
+    qDebug("Checkpoint of SQLite database moved %d of %d pages from WAL journal to database file.",
+           query_checkpoint.value(2).toInt(),
+           query_checkpoint.value(1).toInt());
+  }
+  else {
+    qWarning("Checkpoint of SQLite database failed: '%s'.", qPrintable(query_checkpoint.lastError().text()));
+  }
+}
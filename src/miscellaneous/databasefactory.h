@@ -60,6 +60,11 @@ class DatabaseFactory : public QObject {
     QString humanDriverName(UsedDriver driver) const;
     QString humanDriverName(const QString& driver_code) const;
 
+    // Returns read-only connection for the calling thread.
+    // NOTE: With SQLite, readers are not blocked by the writer
+    // connection, even if it is in the middle of commit.
+    QSqlDatabase readConnection();
+
     // Removes connection.
     void removeConnection(const QString& connection_name = QString());
 
@@ -72,6 +77,11 @@ class DatabaseFactory : public QObject {
     // Performs cleanup of the database.
     bool vacuumDatabase();
 
+    // Copies changes from SQLite WAL journal to the database file.
+    // Passive checkpoint does not wait for other connections, truncating one
+    // waits for them and then empties the journal file.
+    void checkpointDatabase(const QSqlDatabase& database, bool truncate = false);
+
     // Returns identification of currently active database driver.
     UsedDriver activeDatabaseDriver() const;
 
@@ -148,6 +158,10 @@ class DatabaseFactory : public QObject {
     // Assemblies database file path.
     void sqliteAssemblyDatabaseFilePath();
 
+    // Sets properties of new connection to file-based database,
+    // which depend on its role.
+    void sqliteSetupFileBasedConnection(QSqlDatabase database, const QString& connection_name);
+
     // Updates database schema.
     bool sqliteUpdateDatabaseSchema(QSqlDatabase database, const QString& source_db_schema_version);
 
@@ -4,6 +4,7 @@
 
 #include "miscellaneous/application.h"
 #include "miscellaneous/iconfactory.h"
+#include "miscellaneous/stringpool.h"
 #include "miscellaneous/textfactory.h"
 #include "network-web/oauth2service.h"
 #include "services/abstract/category.h"
@@ -29,6 +30,82 @@
 #include <QSqlError>
 #include <QUrl>
 #include <QVariant>
+#include <QVector>
+
+// Returns comma-separated list of given count of positional placeholders.
+static QString positionalPlaceholders(int count) {
+  QStringList placeholders;
+
+  placeholders.reserve(count);
+
+  for (int i = 0; i < count; i++) {
+    placeholders.append(QSL("?"));
+  }
+
+  return placeholders.join(QSL(", "));
+}
+
+QString DatabaseQueries::messageCountsForCategorySql(bool including_total_counts) {
+  return QString("SELECT feed, sum((is_read + 1) % 2)%1 FROM Messages "
+                 "WHERE feed IN (SELECT custom_id FROM Feeds WHERE category = :category AND account_id = :account_id) "
+                 "AND is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id "
+                 "GROUP BY feed;").arg(including_total_counts ? QSL(", count(*)") : QString());
+}
+
+QString DatabaseQueries::messageCountsForAccountSql(bool including_total_counts) {
+  return QString("SELECT feed, sum((is_read + 1) % 2)%1 FROM Messages "
+                 "WHERE is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id "
+                 "GROUP BY feed;").arg(including_total_counts ? QSL(", count(*)") : QString());
+}
+
+QString DatabaseQueries::messageCountsForFeedSql(bool including_total_counts) {
+  return QString("SELECT count(*) FROM Messages "
+                 "WHERE feed = :feed AND is_deleted = 0 AND is_pdeleted = 0%1 AND account_id = :account_id;")
+         .arg(including_total_counts ? QString() : QSL(" AND is_read = 0"));
+}
+
+QString DatabaseQueries::messageCountsForBinSql(bool including_total_counts) {
+  return QString("SELECT count(*) FROM Messages "
+                 "WHERE %1is_deleted = 1 AND is_pdeleted = 0 AND account_id = :account_id;")
+         .arg(including_total_counts ? QString() : QSL("is_read = 0 AND "));
+}
+
+QString DatabaseQueries::publishingHistorySql() {
+  return QSL("SELECT "
+             "(SELECT count(*) FROM Messages WHERE account_id = ? AND feed = ? AND date_created >= ?), "
+             "(SELECT max(date_created) FROM Messages WHERE account_id = ? AND feed = ?);");
+}
+
+QString DatabaseQueries::existingMessagesByHashSql(int hash_count) {
+  return QString("SELECT id, date_created, is_read, is_important, feed, identity_hash FROM Messages "
+                 "WHERE account_id = ? AND feed = ? AND identity_hash IN (%1);").arg(positionalPlaceholders(hash_count));
+}
+
+QString DatabaseQueries::existingMessagesByCustomIdSql(int custom_id_count) {
+  return QString("SELECT id, date_created, is_read, is_important, feed, custom_id FROM Messages "
+                 "WHERE account_id = ? AND custom_id IN (%1);").arg(positionalPlaceholders(custom_id_count));
+}
+
+QString DatabaseQueries::messagesWithoutIdentityHashSql() {
+  return QSL("SELECT id, title, url, author FROM Messages "
+             "WHERE account_id = :account_id AND feed = :feed AND identity_hash IS NULL;");
+}
+
+QString DatabaseQueries::assignMissingCustomIdsSql() {
+  return QSL("UPDATE Messages SET custom_id = id WHERE account_id = :account_id AND custom_id = '';");
+}
+
+QString DatabaseQueries::messagesFilterForFeeds(const QStringList& quoted_feed_custom_ids, int account_id) {
+  // NOTE: Filter is on "Messages.feed" so that messages are looked up
+  // via index instead of scanning all messages of the account.
+  return QString("Messages.feed IN (%1) AND Messages.is_deleted = 0 AND Messages.is_pdeleted = 0 AND Messages.account_id = %2")
+         .arg(quoted_feed_custom_ids.join(QSL(", ")), QString::number(account_id));
+}
+
+QString DatabaseQueries::messagesFilterForBin(int account_id) {
+  return QString("Messages.is_deleted = 1 AND Messages.is_pdeleted = 0 AND Messages.account_id = %1")
+         .arg(QString::number(account_id));
+}
 
 bool DatabaseQueries::markMessagesReadUnread(QSqlDatabase db, const QStringList& ids, RootItem::ReadStatus read) {
   QSqlQuery q(db);
@@ -175,17 +252,7 @@ QMap<QString, QPair<int, int>> DatabaseQueries::getMessageCountsForCategory(QSql
 
   q.setForwardOnly(true);
 
-  if (including_total_counts) {
-    q.prepare("SELECT feed, sum((is_read + 1) % 2), count(*) FROM Messages "
-              "WHERE feed IN (SELECT custom_id FROM Feeds WHERE category = :category AND account_id = :account_id) AND is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id "
-              "GROUP BY feed;");
-  }
-  else {
-    q.prepare("SELECT feed, sum((is_read + 1) % 2) FROM Messages "
-              "WHERE feed IN (SELECT custom_id FROM Feeds WHERE category = :category AND account_id = :account_id) AND is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id "
-              "GROUP BY feed;");
-  }
-
+  q.prepare(messageCountsForCategorySql(including_total_counts));
   q.bindValue(QSL(":category"), custom_id);
   q.bindValue(QSL(":account_id"), account_id);
 
@@ -224,17 +291,7 @@ QMap<QString, QPair<int, int>> DatabaseQueries::getMessageCountsForAccount(QSqlD
 
   q.setForwardOnly(true);
 
-  if (including_total_counts) {
-    q.prepare("SELECT feed, sum((is_read + 1) % 2), count(*) FROM Messages "
-              "WHERE is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id "
-              "GROUP BY feed;");
-  }
-  else {
-    q.prepare("SELECT feed, sum((is_read + 1) % 2) FROM Messages "
-              "WHERE is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id "
-              "GROUP BY feed;");
-  }
-
+  q.prepare(messageCountsForAccountSql(including_total_counts));
   q.bindValue(QSL(":account_id"), account_id);
 
   if (q.exec()) {
@@ -265,21 +322,53 @@ QMap<QString, QPair<int, int>> DatabaseQueries::getMessageCountsForAccount(QSqlD
   return counts;
 }
 
-int DatabaseQueries::getMessageCountsForFeed(QSqlDatabase db, const QString& feed_custom_id,
-                                             int account_id, bool including_total_counts, bool* ok) {
+QMap<QString, QPair<int, qint64>> DatabaseQueries::getPublishingHistoryForFeeds(QSqlDatabase db, int account_id,
+                                                                                const QStringList& feed_custom_ids,
+                                                                                qint64 since, bool* ok) {
+  QMap<QString, QPair<int, qint64>> history;
   QSqlQuery q(db);
 
   q.setForwardOnly(true);
 
-  if (including_total_counts) {
-    q.prepare("SELECT count(*) FROM Messages "
-              "WHERE feed = :feed AND is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id;");
+  // NOTE: Deleted messages are counted too, they were published after all.
+  // Feeds are queried one by one, so that both values are looked up in
+  // index of messages sorted by date and older messages are never read.
+  q.prepare(publishingHistorySql());
+
+  foreach (const QString& feed_custom_id, feed_custom_ids) {
+    q.addBindValue(account_id);
+    q.addBindValue(feed_custom_id);
+    q.addBindValue(since);
+    q.addBindValue(account_id);
+    q.addBindValue(feed_custom_id);
+
+    if (!q.exec() || !q.next()) {
+      if (ok != nullptr) {
+        *ok = false;
+      }
+
+      return history;
+    }
+
+    history.insert(feed_custom_id, QPair<int, qint64>(q.value(0).toInt(),
+                                                      q.value(1).isNull() ? 0 : q.value(1).value<qint64>()));
+    q.finish();
   }
-  else {
-    q.prepare("SELECT count(*) FROM Messages "
-              "WHERE feed = :feed AND is_deleted = 0 AND is_pdeleted = 0 AND is_read = 0 AND account_id = :account_id;");
+
+  if (ok != nullptr) {
+    *ok = true;
   }
 
+  return history;
+}
+
+int DatabaseQueries::getMessageCountsForFeed(QSqlDatabase db, const QString& feed_custom_id,
+                                             int account_id, bool including_total_counts, bool* ok) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+
+  q.prepare(messageCountsForFeedSql(including_total_counts));
   q.bindValue(QSL(":feed"), feed_custom_id);
   q.bindValue(QSL(":account_id"), account_id);
 
@@ -304,15 +393,7 @@ int DatabaseQueries::getMessageCountsForBin(QSqlDatabase db, int account_id, boo
 
   q.setForwardOnly(true);
 
-  if (including_total_counts) {
-    q.prepare("SELECT count(*) FROM Messages "
-              "WHERE is_deleted = 1 AND is_pdeleted = 0 AND account_id = :account_id;");
-  }
-  else {
-    q.prepare("SELECT count(*) FROM Messages "
-              "WHERE is_read = 0 AND is_deleted = 1 AND is_pdeleted = 0 AND account_id = :account_id;");
-  }
-
+  q.prepare(messageCountsForBinSql(including_total_counts));
   q.bindValue(QSL(":account_id"), account_id);
 
   if (q.exec() && q.next()) {
@@ -343,9 +424,11 @@ QList<Message> DatabaseQueries::getUndeletedMessagesForFeed(QSqlDatabase db, con
   q.bindValue(QSL(":account_id"), account_id);
 
   if (q.exec()) {
+    StringPool string_pool;
+
     while (q.next()) {
       bool decoded;
-      Message message = Message::fromSqlRecord(q.record(), &decoded);
+      Message message = Message::fromSqlRecord(q.record(), &decoded, &string_pool);
 
       if (decoded) {
         messages.append(message);
@@ -376,9 +459,11 @@ QList<Message> DatabaseQueries::getUndeletedMessagesForBin(QSqlDatabase db, int
   q.bindValue(QSL(":account_id"), account_id);
 
   if (q.exec()) {
+    StringPool string_pool;
+
     while (q.next()) {
       bool decoded;
-      Message message = Message::fromSqlRecord(q.record(), &decoded);
+      Message message = Message::fromSqlRecord(q.record(), &decoded, &string_pool);
 
       if (decoded) {
         messages.append(message);
@@ -409,9 +494,11 @@ QList<Message> DatabaseQueries::getUndeletedMessagesForAccount(QSqlDatabase db,
   q.bindValue(QSL(":account_id"), account_id);
 
   if (q.exec()) {
+    StringPool string_pool;
+
     while (q.next()) {
       bool decoded;
-      Message message = Message::fromSqlRecord(q.record(), &decoded);
+      Message message = Message::fromSqlRecord(q.record(), &decoded, &string_pool);
 
       if (decoded) {
         messages.append(message);
@@ -431,66 +518,179 @@ QList<Message> DatabaseQueries::getUndeletedMessagesForAccount(QSqlDatabase db,
   return messages;
 }
 
+// State of message which is already stored in DB or which
+// is going to be inserted or updated by updateMessages().
+struct StoredMessageState {
+  int m_id;
+  qint64 m_created;
+  bool m_isRead;
+  bool m_isImportant;
+  QString m_feedId;
+  bool m_hasContents;
+  QString m_contents;
+
+  // Index of pending insert or update of this message.
+  int m_pendingInsert;
+  int m_pendingUpdate;
+};
+
+// Message which will be written to DB, "m_unreadUpdates" is count of
+// decisions to update the message with unread contents, each of them
+// counts as one updated message.
+struct PendingMessageWrite {
+  Message m_message;
+  QString m_feed;
+  qint64 m_identityHash;
+  int m_id;
+  int m_unreadUpdates;
+};
+
+static StoredMessageState storedMessageState(const QSqlQuery& query) {
+  StoredMessageState state;
+
+  state.m_id = query.value(0).toInt();
+  state.m_created = query.value(1).value<qint64>();
+  state.m_isRead = query.value(2).toBool();
+  state.m_isImportant = query.value(3).toBool();
+  state.m_feedId = query.value(4).toString();
+  state.m_hasContents = false;
+  state.m_pendingInsert = -1;
+  state.m_pendingUpdate = -1;
+  return state;
+}
+
+template<typename Key>
+static StoredMessageState* findStoredState(QHash<Key, StoredMessageState>& states, const Key& key) {
+  typename QHash<Key, StoredMessageState>::iterator state = states.find(key);
+
+  return state == states.end() ? nullptr : &state.value();
+}
+
+template<typename Key>
+static void assignStoredContents(QHash<Key, StoredMessageState>& states, const QHash<int, QString>& contents) {
+  for (typename QHash<Key, StoredMessageState>::iterator i = states.begin(); i != states.end(); i++) {
+    QHash<int, QString>::const_iterator stored_contents = contents.constFind(i.value().m_id);
+
+    if (stored_contents != contents.constEnd()) {
+      i.value().m_contents = stored_contents.value();
+      i.value().m_hasContents = true;
+    }
+  }
+}
+
+static void bindMessageForInsert(QSqlQuery& query, const PendingMessageWrite& write, int account_id) {
+  query.addBindValue(write.m_feed);
+  query.addBindValue(write.m_message.m_title);
+  query.addBindValue((int) write.m_message.m_isRead);
+  query.addBindValue((int) write.m_message.m_isImportant);
+  query.addBindValue(write.m_message.m_url);
+  query.addBindValue(write.m_message.m_author);
+  query.addBindValue(write.m_message.m_created.toMSecsSinceEpoch());
+  query.addBindValue(write.m_message.m_contents);
+  query.addBindValue(Enclosures::encodeEnclosuresToString(write.m_message.m_enclosures));
+  // Missing custom ID is stored as empty string, so that
+  // assignMissingCustomIds() finds the row via index.
+  query.addBindValue(write.m_message.m_customId.isEmpty() ? QSL("") : write.m_message.m_customId);
+  query.addBindValue(write.m_message.m_customHash);
+  query.addBindValue(account_id);
+  query.addBindValue(write.m_identityHash);
+}
+
+static void bindMessageForUpdate(QSqlQuery& query, const PendingMessageWrite& write) {
+  query.addBindValue(write.m_message.m_title);
+  query.addBindValue((int) write.m_message.m_isRead);
+  query.addBindValue((int) write.m_message.m_isImportant);
+  query.addBindValue(write.m_message.m_url);
+  query.addBindValue(write.m_message.m_author);
+  query.addBindValue(write.m_message.m_created.toMSecsSinceEpoch());
+  query.addBindValue(write.m_message.m_contents);
+  query.addBindValue(Enclosures::encodeEnclosuresToString(write.m_message.m_enclosures));
+  query.addBindValue(write.m_feed);
+  query.addBindValue(write.m_identityHash);
+  query.addBindValue(write.m_id);
+}
+
+// Calculates identity hashes of messages of the feed which
+// were stored before the hashes were introduced.
+static void assignMissingIdentityHashes(QSqlDatabase db, const QString& feed_custom_id, int account_id) {
+  QSqlQuery query_select(db);
+  QVariantList hashes, ids;
+
+  query_select.setForwardOnly(true);
+  query_select.prepare(DatabaseQueries::messagesWithoutIdentityHashSql());
+  query_select.bindValue(QSL(":account_id"), account_id);
+  query_select.bindValue(QSL(":feed"), feed_custom_id);
+
+  if (!query_select.exec()) {
+    qWarning("Failed to load messages without identity hash from DB: '%s'.", qPrintable(query_select.lastError().text()));
+    return;
+  }
+
+  while (query_select.next()) {
+    Message message;
+
+    message.m_title = query_select.value(1).toString();
+    message.m_url = query_select.value(2).toString();
+    message.m_author = query_select.value(3).toString();
+
+    ids << query_select.value(0).toInt();
+    hashes << static_cast<qint64>(message.identityHash());
+  }
+
+  if (ids.isEmpty()) {
+    return;
+  }
+
+  QSqlQuery query_update(db);
+
+  query_update.prepare(QSL("UPDATE Messages SET identity_hash = ? WHERE id = ?;"));
+  query_update.addBindValue(hashes);
+  query_update.addBindValue(ids);
+
+  if (query_update.execBatch()) {
+    qDebug("Assigned identity hashes to %d messages of feed '%s'.", ids.size(), qPrintable(feed_custom_id));
+  }
+  else {
+    qWarning("Failed to assign identity hashes to messages: '%s'.", qPrintable(query_update.lastError().text()));
+  }
+}
+
 int DatabaseQueries::updateMessages(QSqlDatabase db,
-                                    const QList<Message>& messages,
+                                    QList<Message>& messages,
                                     const QString& feed_custom_id,
                                     int account_id,
                                     const QString& url,
                                     bool* any_message_changed,
-                                    bool* ok) {
+                                    bool* ok,
+                                    bool external_transaction) {
   if (messages.isEmpty()) {
     *any_message_changed = false;
     *ok = true;
     return 0;
   }
 
-  bool use_transactions = qApp->settings()->value(GROUP(Database), SETTING(Database::UseTransactions)).toBool();
+  bool use_transactions = !external_transaction &&
+                          qApp->settings()->value(GROUP(Database), SETTING(Database::UseTransactions)).toBool();
 
   // Does not make any difference, since each feed now has
   // its own "custom ID" (standard feeds have their custom ID equal to primary key ID).
   int updated_messages = 0;
-
-  // Prepare queries.
-  QSqlQuery query_select_with_url(db);
-  QSqlQuery query_select_with_id(db);
-  QSqlQuery query_update(db);
-  QSqlQuery query_insert(db);
   QSqlQuery query_begin_transaction(db);
 
-  // Here we have query which will check for existence of the "same" message in given feed.
-  // The two message are the "same" if:
-  //   1) they belong to the same feed AND,
-  //   2) they have same URL AND,
-  //   3) they have same AUTHOR AND,
-  //   4) they have same title.
-  query_select_with_url.setForwardOnly(true);
-  query_select_with_url.prepare("SELECT id, date_created, is_read, is_important, contents, feed FROM Messages "
-                                "WHERE feed = :feed AND title = :title AND url = :url AND author = :author AND account_id = :account_id;");
-
-  // When we have custom ID of the message, we can check directly for existence
-  // of that particular message.
-  query_select_with_id.setForwardOnly(true);
-  query_select_with_id.prepare("SELECT id, date_created, is_read, is_important, contents, feed FROM Messages "
-                               "WHERE custom_id = :custom_id AND account_id = :account_id;");
-
-  // Used to insert new messages.
-  query_insert.setForwardOnly(true);
-  query_insert.prepare("INSERT INTO Messages "
-                       "(feed, title, is_read, is_important, url, author, date_created, contents, enclosures, custom_id, custom_hash, account_id) "
-                       "VALUES (:feed, :title, :is_read, :is_important, :url, :author, :date_created, :contents, :enclosures, :custom_id, :custom_hash, :account_id);");
-
-  // Used to update existing messages.
-  query_update.setForwardOnly(true);
-  query_update.prepare("UPDATE Messages "
-                       "SET title = :title, is_read = :is_read, is_important = :is_important, url = :url, author = :author, date_created = :date_created, contents = :contents, enclosures = :enclosures, feed = :feed "
-                       "WHERE id = :id;");
-
   if (use_transactions && !query_begin_transaction.exec(qApp->database()->obtainBeginTransactionSql())) {
     qCritical("Transaction start for message downloader failed: '%s'.", qPrintable(query_begin_transaction.lastError().text()));
     return updated_messages;
   }
 
-  foreach (Message message, messages) {
+  bool any_without_custom_id = false;
+  QStringList custom_ids;
+  QVector<qint64> identity_hashes;
+
+  identity_hashes.reserve(messages.size());
+
+  for (int i = 0; i < messages.size(); i++) {
+    Message& message = messages[i];
+
     // Check if messages contain relative URLs and if they do, then replace them.
     if (message.m_url.startsWith(QL1S("//"))) {
       message.m_url = QString(URI_SCHEME_HTTP) + message.m_url.mid(2);
@@ -506,144 +706,365 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
       message.m_url = new_message_url;
     }
 
-    int id_existing_message = -1;
-    qint64 date_existing_message;
-    bool is_read_existing_message;
-    bool is_important_existing_message;
-    QString contents_existing_message;
-    QString feed_id_existing_message;
+    // Hash is stored as signed integer, because neither SQLite nor MySQL
+    // have unsigned 64-bit type which would work everywhere.
+    identity_hashes.append(static_cast<qint64>(message.identityHash()));
 
     if (message.m_customId.isEmpty()) {
-      // We need to recognize existing messages according URL & AUTHOR & TITLE.
-      // NOTE: This particularly concerns messages from standard account.
-      query_select_with_url.bindValue(QSL(":feed"), feed_custom_id);
-      query_select_with_url.bindValue(QSL(":title"), message.m_title);
-      query_select_with_url.bindValue(QSL(":url"), message.m_url);
-      query_select_with_url.bindValue(QSL(":author"), message.m_author);
-      query_select_with_url.bindValue(QSL(":account_id"), account_id);
-
-      qDebug("Checking if message with title '%s', url '%s' and author '%s' is present in DB.",
-             qPrintable(message.m_title), qPrintable(message.m_url), qPrintable(message.m_author));
-
-      if (query_select_with_url.exec() && query_select_with_url.next()) {
-        id_existing_message = query_select_with_url.value(0).toInt();
-        date_existing_message = query_select_with_url.value(1).value<qint64>();
-        is_read_existing_message = query_select_with_url.value(2).toBool();
-        is_important_existing_message = query_select_with_url.value(3).toBool();
-        contents_existing_message = query_select_with_url.value(4).toString();
-        feed_id_existing_message = query_select_with_url.value(5).toString();
-
-        qDebug("Message with these attributes is already present in DB and has DB ID %d.", id_existing_message);
+      any_without_custom_id = true;
+    }
+    else {
+      custom_ids.append(message.m_customId);
+    }
+  }
+
+  // Keys of existing messages are loaded at once instead of checking each message separately.
+  // The two message are the "same" if:
+  //   1) they belong to the same feed AND,
+  //   2) they have same identity hash, which is calculated from their URL, AUTHOR and title.
+  // When we have custom ID of the message, we can check directly for existence
+  // of that particular message.
+  QHash<qint64, StoredMessageState> states_by_hash;
+  QHash<QString, StoredMessageState> states_by_custom_id;
+
+  if (any_without_custom_id) {
+    // NOTE: This particularly concerns messages from standard account.
+    assignMissingIdentityHashes(db, feed_custom_id, account_id);
+
+    QList<qint64> hashes;
+
+    for (int i = 0; i < messages.size(); i++) {
+      if (messages.at(i).m_customId.isEmpty()) {
+        hashes.append(identity_hashes.at(i));
+      }
+    }
+
+    hashes = hashes.toSet().toList();
+
+    for (int i = 0; i < hashes.size(); i += DATABASE_BULK_CHUNK_SIZE) {
+      const QList<qint64> chunk = hashes.mid(i, DATABASE_BULK_CHUNK_SIZE);
+      QSqlQuery query_select_with_hash(db);
+
+      query_select_with_hash.setForwardOnly(true);
+      query_select_with_hash.prepare(existingMessagesByHashSql(chunk.size()));
+      query_select_with_hash.addBindValue(account_id);
+      query_select_with_hash.addBindValue(feed_custom_id);
+
+      foreach (qint64 hash, chunk) {
+        query_select_with_hash.addBindValue(hash);
+      }
+
+      if (query_select_with_hash.exec()) {
+        while (query_select_with_hash.next()) {
+          const qint64 hash = query_select_with_hash.value(5).value<qint64>();
+
+          if (!states_by_hash.contains(hash)) {
+            states_by_hash.insert(hash, storedMessageState(query_select_with_hash));
+          }
+        }
       }
-      else if (query_select_with_url.lastError().isValid()) {
-        qWarning("Failed to check for existing message in DB via URL: '%s'.", qPrintable(query_select_with_url.lastError().text()));
+      else {
+        qWarning("Failed to load existing messages of feed from DB via hash: '%s'.",
+                 qPrintable(query_select_with_hash.lastError().text()));
       }
+    }
+  }
+
+  custom_ids.removeDuplicates();
+
+  // NOTE: This concerns messages from custom accounts, like TT-RSS or ownCloud News.
+  for (int i = 0; i < custom_ids.size(); i += DATABASE_BULK_CHUNK_SIZE) {
+    const QStringList chunk = custom_ids.mid(i, DATABASE_BULK_CHUNK_SIZE);
+    QSqlQuery query_select_with_id(db);
 
-      query_select_with_url.finish();
+    query_select_with_id.setForwardOnly(true);
+    query_select_with_id.prepare(existingMessagesByCustomIdSql(chunk.size()));
+    query_select_with_id.addBindValue(account_id);
+
+    foreach (const QString& custom_id, chunk) {
+      query_select_with_id.addBindValue(custom_id);
+    }
+
+    if (query_select_with_id.exec()) {
+      while (query_select_with_id.next()) {
+        const QString custom_id = query_select_with_id.value(5).toString();
+
+        if (!states_by_custom_id.contains(custom_id)) {
+          states_by_custom_id.insert(custom_id, storedMessageState(query_select_with_id));
+        }
+      }
     }
     else {
-      // We can recognize existing messages via their custom ID.
-      // NOTE: This concerns messages from custom accounts, like TT-RSS or ownCloud News.
-      query_select_with_id.bindValue(QSL(":account_id"), account_id);
-      query_select_with_id.bindValue(QSL(":custom_id"), message.m_customId);
-
-      qDebug("Checking if message with custom ID %s is present in DB.", qPrintable(message.m_customId));
-
-      if (query_select_with_id.exec() && query_select_with_id.next()) {
-        id_existing_message = query_select_with_id.value(0).toInt();
-        date_existing_message = query_select_with_id.value(1).value<qint64>();
-        is_read_existing_message = query_select_with_id.value(2).toBool();
-        is_important_existing_message = query_select_with_id.value(3).toBool();
-        contents_existing_message = query_select_with_id.value(4).toString();
-        feed_id_existing_message = query_select_with_id.value(5).toString();
-
-        qDebug("Message with custom ID %s is already present in DB and has DB ID %d.",
-               qPrintable(message.m_customId), id_existing_message);
+      qWarning("Failed to load existing messages from DB via ID: '%s'.", qPrintable(query_select_with_id.lastError().text()));
+    }
+  }
+
+  // Contents are needed only for messages whose date changed,
+  // so we do not load contents of whole feed.
+  QStringList ids_for_contents;
+
+  for (int i = 0; i < messages.size(); i++) {
+    const Message& message = messages.at(i);
+    const StoredMessageState* state = message.m_customId.isEmpty()
+                                      ? findStoredState(states_by_hash, identity_hashes.at(i))
+                                      : findStoredState(states_by_custom_id, message.m_customId);
+
+    if (message.m_createdFromFeed && state != nullptr && state->m_created != message.m_created.toMSecsSinceEpoch()) {
+      ids_for_contents.append(QString::number(state->m_id));
+    }
+  }
+
+  if (!ids_for_contents.isEmpty()) {
+    QHash<int, QString> contents;
+
+    ids_for_contents.removeDuplicates();
+
+    for (int i = 0; i < ids_for_contents.size(); i += DATABASE_BULK_CHUNK_SIZE) {
+      QSqlQuery query_select_contents(db);
+
+      query_select_contents.setForwardOnly(true);
+
+      if (query_select_contents.exec(QString("SELECT id, contents FROM Messages WHERE id IN (%1);")
+                                     .arg(ids_for_contents.mid(i, DATABASE_BULK_CHUNK_SIZE).join(QSL(", "))))) {
+        while (query_select_contents.next()) {
+          contents.insert(query_select_contents.value(0).toInt(), query_select_contents.value(1).toString());
+        }
       }
-      else if (query_select_with_id.lastError().isValid()) {
-        qDebug("Failed to check for existing message in DB via ID: '%s'.", qPrintable(query_select_with_id.lastError().text()));
+      else {
+        qWarning("Failed to load contents of existing messages from DB: '%s'.",
+                 qPrintable(query_select_contents.lastError().text()));
       }
-
-      query_select_with_id.finish();
     }
 
+    assignStoredContents(states_by_hash, contents);
+    assignStoredContents(states_by_custom_id, contents);
+  }
+
+  // Now decide what to do with each message. Messages are processed in their
+  // order and their decisions are remembered, so that duplicate messages
+  // in one batch are handled as if they were stored one by one.
+  QList<PendingMessageWrite> inserts;
+  QList<PendingMessageWrite> updates;
+
+  for (int i = 0; i < messages.size(); i++) {
+    const Message& message = messages.at(i);
+    const qint64 identity_hash = identity_hashes.at(i);
+    StoredMessageState* state = message.m_customId.isEmpty()
+                                ? findStoredState(states_by_hash, identity_hash)
+                                : findStoredState(states_by_custom_id, message.m_customId);
+
     // Now, check if this message is already in the DB.
-    if (id_existing_message >= 0) {
+    if (state != nullptr) {
+      StoredMessageState& existing = *state;
+
       // Message is already in the DB.
       //
       // Now, we update it if at least one of next conditions is true:
       //   1) Message has custom ID AND (its date OR read status OR starred status are changed).
       //   2) Message has its date fetched from feed AND its date is different from date in DB and contents is changed.
-      if (/* 1 */ (!message.m_customId.isEmpty() && (message.m_created.toMSecsSinceEpoch() != date_existing_message ||
-                                                     message.m_isRead != is_read_existing_message ||
-                                                     message.m_isImportant != is_important_existing_message ||
-                                                     message.m_feedId != feed_id_existing_message)) ||
+      if (/* 1 */ (!message.m_customId.isEmpty() && (message.m_created.toMSecsSinceEpoch() != existing.m_created ||
+                                                     message.m_isRead != existing.m_isRead ||
+                                                     message.m_isImportant != existing.m_isImportant ||
+                                                     message.m_feedId != existing.m_feedId)) ||
 
-                  /* 2 */ (message.m_createdFromFeed && message.m_created.toMSecsSinceEpoch() != date_existing_message
-                           && message.m_contents != contents_existing_message)) {
+                  /* 2 */ (message.m_createdFromFeed && message.m_created.toMSecsSinceEpoch() != existing.m_created
+                           && (!existing.m_hasContents || message.m_contents != existing.m_contents))) {
         // Message exists, it is changed, update it.
-        query_update.bindValue(QSL(":title"), message.m_title);
-        query_update.bindValue(QSL(":is_read"), (int) message.m_isRead);
-        query_update.bindValue(QSL(":is_important"), (int) message.m_isImportant);
-        query_update.bindValue(QSL(":url"), message.m_url);
-        query_update.bindValue(QSL(":author"), message.m_author);
-        query_update.bindValue(QSL(":date_created"), message.m_created.toMSecsSinceEpoch());
-        query_update.bindValue(QSL(":contents"), message.m_contents);
-        query_update.bindValue(QSL(":enclosures"), Enclosures::encodeEnclosuresToString(message.m_enclosures));
-        query_update.bindValue(QSL(":feed"), message.m_feedId);
-        query_update.bindValue(QSL(":id"), id_existing_message);
-        *any_message_changed = true;
-
-        if (query_update.exec()) {
-          qDebug("Updating message with title '%s' url '%s' in DB.", qPrintable(message.m_title), qPrintable(message.m_url));
+        PendingMessageWrite* write;
 
-          if (!message.m_isRead) {
-            updated_messages++;
+        if (existing.m_pendingInsert >= 0) {
+          write = &inserts[existing.m_pendingInsert];
+        }
+        else {
+          if (existing.m_pendingUpdate < 0) {
+            existing.m_pendingUpdate = updates.size();
+            updates.append(PendingMessageWrite { Message(), QString(), 0, existing.m_id, 0 });
           }
+
+          write = &updates[existing.m_pendingUpdate];
         }
-        else if (query_update.lastError().isValid()) {
-          qWarning("Failed to update message in DB: '%s'.", qPrintable(query_update.lastError().text()));
+
+        // Update changes all columns but custom ID and hash.
+        write->m_message.m_title = message.m_title;
+        write->m_message.m_isRead = message.m_isRead;
+        write->m_message.m_isImportant = message.m_isImportant;
+        write->m_message.m_url = message.m_url;
+        write->m_message.m_author = message.m_author;
+        write->m_message.m_created = message.m_created;
+        write->m_message.m_contents = message.m_contents;
+        write->m_message.m_enclosures = message.m_enclosures;
+        write->m_feed = message.m_feedId;
+        write->m_identityHash = identity_hash;
+
+        if (!message.m_isRead) {
+          write->m_unreadUpdates++;
         }
 
-        query_update.finish();
+        existing.m_created = message.m_created.toMSecsSinceEpoch();
+        existing.m_isRead = message.m_isRead;
+        existing.m_isImportant = message.m_isImportant;
+        existing.m_feedId = message.m_feedId;
+        existing.m_contents = message.m_contents;
+        existing.m_hasContents = true;
+        *any_message_changed = true;
       }
     }
     else {
       // Message with this URL is not fetched in this feed yet.
-      query_insert.bindValue(QSL(":feed"), feed_custom_id);
-      query_insert.bindValue(QSL(":title"), message.m_title);
-      query_insert.bindValue(QSL(":is_read"), (int) message.m_isRead);
-      query_insert.bindValue(QSL(":is_important"), (int) message.m_isImportant);
-      query_insert.bindValue(QSL(":url"), message.m_url);
-      query_insert.bindValue(QSL(":author"), message.m_author);
-      query_insert.bindValue(QSL(":date_created"), message.m_created.toMSecsSinceEpoch());
-      query_insert.bindValue(QSL(":contents"), message.m_contents);
-      query_insert.bindValue(QSL(":enclosures"), Enclosures::encodeEnclosuresToString(message.m_enclosures));
-      query_insert.bindValue(QSL(":custom_id"), message.m_customId);
-      query_insert.bindValue(QSL(":custom_hash"), message.m_customHash);
-      query_insert.bindValue(QSL(":account_id"), account_id);
-
-      if (query_insert.exec() && query_insert.numRowsAffected() == 1) {
-        updated_messages++;
-
-        qDebug("Adding new message with title '%s' url '%s' to DB.", qPrintable(message.m_title), qPrintable(message.m_url));
+      StoredMessageState inserted;
+
+      inserted.m_id = -1;
+      inserted.m_created = message.m_created.toMSecsSinceEpoch();
+      inserted.m_isRead = message.m_isRead;
+      inserted.m_isImportant = message.m_isImportant;
+      inserted.m_feedId = feed_custom_id;
+      inserted.m_hasContents = true;
+      inserted.m_contents = message.m_contents;
+      inserted.m_pendingInsert = inserts.size();
+      inserted.m_pendingUpdate = -1;
+
+      if (message.m_customId.isEmpty()) {
+        states_by_hash.insert(identity_hash, inserted);
+      }
+      else {
+        states_by_custom_id.insert(message.m_customId, inserted);
       }
-      else if (query_insert.lastError().isValid()) {
+
+      inserts.append(PendingMessageWrite { message, feed_custom_id, identity_hash, -1, 0 });
+    }
+  }
+
+  // Changed messages are updated in one batch.
+  if (!updates.isEmpty()) {
+    const QString update_sql = QSL("UPDATE Messages "
+                                   "SET title = ?, is_read = ?, is_important = ?, url = ?, author = ?, date_created = ?, "
+                                   "contents = ?, enclosures = ?, feed = ?, identity_hash = ? "
+                                   "WHERE id = ?;");
+    QSqlQuery query_update(db);
+    QVariantList titles, is_reads, is_importants, urls, authors, dates, contents, enclosures, feeds, hashes, ids;
+
+    foreach (const PendingMessageWrite& update, updates) {
+      titles << update.m_message.m_title;
+      is_reads << (int) update.m_message.m_isRead;
+      is_importants << (int) update.m_message.m_isImportant;
+      urls << update.m_message.m_url;
+      authors << update.m_message.m_author;
+      dates << update.m_message.m_created.toMSecsSinceEpoch();
+      contents << update.m_message.m_contents;
+      enclosures << Enclosures::encodeEnclosuresToString(update.m_message.m_enclosures);
+      feeds << update.m_feed;
+      hashes << update.m_identityHash;
+      ids << update.m_id;
+    }
+
+    query_update.prepare(update_sql);
+    query_update.addBindValue(titles);
+    query_update.addBindValue(is_reads);
+    query_update.addBindValue(is_importants);
+    query_update.addBindValue(urls);
+    query_update.addBindValue(authors);
+    query_update.addBindValue(dates);
+    query_update.addBindValue(contents);
+    query_update.addBindValue(enclosures);
+    query_update.addBindValue(feeds);
+    query_update.addBindValue(hashes);
+    query_update.addBindValue(ids);
+
+    if (query_update.execBatch()) {
+      qDebug("Updated %d messages in DB.", updates.size());
+
+      foreach (const PendingMessageWrite& update, updates) {
+        updated_messages += update.m_unreadUpdates;
+      }
+    }
+    else {
+      qWarning("Failed to update messages in DB in batch, updating them one by one: '%s'.",
+               qPrintable(query_update.lastError().text()));
+
+      QSqlQuery query_update_one(db);
+
+      query_update_one.prepare(update_sql);
+
+      foreach (const PendingMessageWrite& update, updates) {
+        bindMessageForUpdate(query_update_one, update);
+
+        if (query_update_one.exec()) {
+          updated_messages += update.m_unreadUpdates;
+        }
+        else {
+          qWarning("Failed to update message in DB: '%s'.", qPrintable(query_update_one.lastError().text()));
+        }
+
+        query_update_one.finish();
+      }
+    }
+  }
+
+  // New messages are inserted by multi-row statements.
+  const QString insert_sql = QSL("INSERT INTO Messages "
+                                 "(feed, title, is_read, is_important, url, author, date_created, contents, enclosures, custom_id, custom_hash, account_id, identity_hash) "
+                                 "VALUES %1;");
+  const QString insert_row = QSL("(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+  bool any_inserted_without_custom_id = false;
+
+  foreach (const PendingMessageWrite& insert, inserts) {
+    if (insert.m_message.m_customId.isEmpty()) {
+      any_inserted_without_custom_id = true;
+      break;
+    }
+  }
+
+  for (int i = 0; i < inserts.size(); i += DATABASE_BULK_INSERT_ROWS) {
+    const int chunk_size = qMin(DATABASE_BULK_INSERT_ROWS, inserts.size() - i);
+    QStringList rows;
+    QSqlQuery query_insert(db);
+
+    for (int j = 0; j < chunk_size; j++) {
+      rows.append(insert_row);
+    }
+
+    query_insert.prepare(insert_sql.arg(rows.join(QSL(", "))));
+
+    for (int j = i; j < i + chunk_size; j++) {
+      bindMessageForInsert(query_insert, inserts.at(j), account_id);
+    }
+
+    if (query_insert.exec()) {
+      qDebug("Added %d new messages to DB.", chunk_size);
+
+      for (int j = i; j < i + chunk_size; j++) {
+        updated_messages += 1 + inserts.at(j).m_unreadUpdates;
+      }
+
+      continue;
+    }
+
+    qWarning("Failed to insert messages to DB in bulk, inserting them one by one: '%s'.",
+             qPrintable(query_insert.lastError().text()));
+
+    QSqlQuery query_insert_one(db);
+
+    query_insert_one.prepare(insert_sql.arg(insert_row));
+
+    for (int j = i; j < i + chunk_size; j++) {
+      bindMessageForInsert(query_insert_one, inserts.at(j), account_id);
+
+      if (query_insert_one.exec() && query_insert_one.numRowsAffected() == 1) {
+        updated_messages += 1 + inserts.at(j).m_unreadUpdates;
+      }
+      else if (query_insert_one.lastError().isValid()) {
         qWarning("Failed to insert message to DB: '%s' - message title is '%s'.",
-                 qPrintable(query_insert.lastError().text()),
-                 qPrintable(message.m_title));
+                 qPrintable(query_insert_one.lastError().text()),
+                 qPrintable(inserts.at(j).m_message.m_title));
       }
 
-      query_insert.finish();
+      query_insert_one.finish();
     }
   }
 
-  // Now, fixup custom IDS for messages which initially did not have them,
-  // just to keep the data consistent.
-  if (db.exec("UPDATE Messages "
-              "SET custom_id = id "
-              "WHERE custom_id IS NULL OR custom_id = '';").lastError().isValid()) {
-    qWarning("Failed to set custom ID for all messages: '%s'.", qPrintable(db.lastError().text()));
+  if (any_inserted_without_custom_id) {
+    // Messages just inserted get their custom IDs right away.
+    assignMissingCustomIds(db, account_id);
   }
 
   if (use_transactions && !db.commit()) {
@@ -664,6 +1085,25 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
   return updated_messages;
 }
 
+bool DatabaseQueries::assignMissingCustomIds(QSqlDatabase db, int account_id) {
+  // Fixup custom IDS for messages which initially did not have them,
+  // just to keep the data consistent. Only rows inserted without custom ID
+  // are looked up, via index, messages from older versions are fixed by DB schema update.
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+  q.prepare(assignMissingCustomIdsSql());
+  q.bindValue(QSL(":account_id"), account_id);
+
+  if (!q.exec()) {
+    qWarning("Failed to set custom ID for all messages: '%s'.", qPrintable(q.lastError().text()));
+    return false;
+  }
+  else {
+    return true;
+  }
+}
+
 bool DatabaseQueries::purgeMessagesFromBin(QSqlDatabase db, bool clear_only_read, int account_id) {
   QSqlQuery q(db);
 
@@ -1246,7 +1686,7 @@ bool DatabaseQueries::editFeed(QSqlDatabase db, int parent_id, int feed_id, cons
 
   q.setForwardOnly(true);
   q.prepare("UPDATE Feeds "
-            "SET title = :title, description = :description, icon = :icon, category = :category, encoding = :encoding, url = :url, protected = :protected, username = :username, password = :password, update_type = :update_type, update_interval = :update_interval, type = :type "
+            "SET title = :title, description = :description, icon = :icon, category = :category, encoding = :encoding, url = :url, protected = :protected, username = :username, password = :password, update_type = :update_type, update_interval = :update_interval, type = :type, http_etag = NULL, http_lastmod = NULL, content_hash = NULL "
             "WHERE id = :id;");
   q.bindValue(QSL(":title"), title);
   q.bindValue(QSL(":description"), description);
@@ -1271,6 +1711,20 @@ bool DatabaseQueries::editFeed(QSqlDatabase db, int parent_id, int feed_id, cons
   return q.exec();
 }
 
+bool DatabaseQueries::storeFeedFetchState(QSqlDatabase db, int feed_id, const QString& etag,
+                                          const QString& last_modified, quint64 content_hash) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("UPDATE Feeds SET http_etag = :http_etag, http_lastmod = :http_lastmod, content_hash = :content_hash "
+                "WHERE id = :id;"));
+  q.bindValue(QSL(":http_etag"), etag);
+  q.bindValue(QSL(":http_lastmod"), last_modified);
+  q.bindValue(QSL(":content_hash"), static_cast<qint64>(content_hash));
+  q.bindValue(QSL(":id"), feed_id);
+  return q.exec();
+}
+
 bool DatabaseQueries::editBaseFeed(QSqlDatabase db, int feed_id, Feed::AutoUpdateType auto_update_type,
                                    int auto_update_interval) {
   QSqlQuery q(db);
@@ -32,6 +32,22 @@ class DatabaseQueries {
     static bool purgeMessagesFromBin(QSqlDatabase db, bool clear_only_read, int account_id);
     static bool purgeLeftoverMessages(QSqlDatabase db, int account_id);
 
+    // SQL of hot queries over messages. Query plans of these statements
+    // are audited by benchmark, do not build these queries elsewhere.
+    static QString messageCountsForCategorySql(bool including_total_counts);
+    static QString messageCountsForAccountSql(bool including_total_counts);
+    static QString messageCountsForFeedSql(bool including_total_counts);
+    static QString messageCountsForBinSql(bool including_total_counts);
+    static QString publishingHistorySql();
+    static QString existingMessagesByHashSql(int hash_count);
+    static QString existingMessagesByCustomIdSql(int custom_id_count);
+    static QString messagesWithoutIdentityHashSql();
+    static QString assignMissingCustomIdsSql();
+
+    // Filters of messages displayed in message list, feed IDs are already quoted.
+    static QString messagesFilterForFeeds(const QStringList& quoted_feed_custom_ids, int account_id);
+    static QString messagesFilterForBin(int account_id);
+
     // Obtain counts of unread/all messages.
     static QMap<QString, QPair<int, int>> getMessageCountsForCategory(QSqlDatabase db, const QString& custom_id, int account_id,
                                                                       bool including_total_counts, bool* ok = nullptr);
@@ -41,6 +57,12 @@ class DatabaseQueries {
                                        bool including_total_counts, bool* ok = nullptr);
     static int getMessageCountsForBin(QSqlDatabase db, int account_id, bool including_total_counts, bool* ok = nullptr);
 
+    // Obtain count of messages created after "since" and creation date of newest message for each
+    // of given feeds. Creation date is 0 for feeds without messages.
+    static QMap<QString, QPair<int, qint64>> getPublishingHistoryForFeeds(QSqlDatabase db, int account_id,
+                                                                         const QStringList& feed_custom_ids,
+                                                                         qint64 since, bool* ok = nullptr);
+
     // Get messages (for newspaper view for example).
     static QList<Message> getUndeletedMessagesForFeed(QSqlDatabase db, const QString& feed_custom_id, int account_id, bool* ok = nullptr);
     static QList<Message> getUndeletedMessagesForBin(QSqlDatabase db, int account_id, bool* ok = nullptr);
@@ -52,12 +74,21 @@ class DatabaseQueries {
     static QStringList customIdsOfMessagesFromFeed(QSqlDatabase db, const QString& feed_custom_id, int account_id, bool* ok = nullptr);
 
     // Common accounts methods.
-    static int updateMessages(QSqlDatabase db, const QList<Message>& messages, const QString& feed_custom_id,
-                              int account_id, const QString& url, bool* any_message_changed, bool* ok = nullptr);
+    // NOTE: If "external_transaction" is true, then caller is responsible for
+    // starting/committing the transaction.
+    // Messages are adjusted in place, so that they do not need to be copied.
+    static int updateMessages(QSqlDatabase db, QList<Message>& messages, const QString& feed_custom_id,
+                              int account_id, const QString& url, bool* any_message_changed, bool* ok = nullptr,
+                              bool external_transaction = false);
+
+    // Sets custom ID of messages of the account which were inserted without it.
+    static bool assignMissingCustomIds(QSqlDatabase db, int account_id);
     static bool deleteAccount(QSqlDatabase db, int account_id);
     static bool deleteAccountData(QSqlDatabase db, int account_id, bool delete_messages_too);
     static bool cleanFeeds(QSqlDatabase db, const QStringList& ids, bool clean_read_only, int account_id);
     static bool storeAccountTree(QSqlDatabase db, RootItem* tree_root, int account_id);
+    static bool storeFeedFetchState(QSqlDatabase db, int feed_id, const QString& etag,
+                                    const QString& last_modified, quint64 content_hash);
     static bool editBaseFeed(QSqlDatabase db, int feed_id, Feed::AutoUpdateType auto_update_type,
                              int auto_update_interval);
     static Assignment getCategories(QSqlDatabase db, int account_id, bool* ok = nullptr);
@@ -24,7 +24,8 @@
 
 FeedReader::FeedReader(QObject* parent)
   : QObject(parent), m_feedServices(QList<ServiceEntryPoint*>()),
-  m_autoUpdateTimer(new QTimer(this)),
+  m_autoUpdateTimer(new QTimer(this)), m_adaptiveAutoUpdateEnabled(false), m_adaptiveIntervalsOutdated(true),
+  m_adaptiveMinInterval(DEFAULT_AUTO_UPDATE_INTERVAL), m_adaptiveMaxInterval(DEFAULT_ADAPTIVE_UPDATE_MAX_INTERVAL),
   m_feedDownloaderThread(nullptr), m_feedDownloader(nullptr),
   m_dbCleanerThread(nullptr), m_dbCleaner(nullptr) {
   m_feedsModel = new FeedsModel(this);
@@ -33,6 +34,14 @@ FeedReader::FeedReader(QObject* parent)
   m_messagesProxyModel = new MessagesProxyModel(m_messagesModel, this);
 
   connect(m_autoUpdateTimer, &QTimer::timeout, this, &FeedReader::executeNextAutoUpdate);
+  connect(this, &FeedReader::feedUpdatesFinished, this, [this](const FeedDownloadResults& results) {
+    // Updated feeds have new messages, so their publishing rates might have changed.
+    // Their history was already obtained by feed downloader in its thread.
+    if (adaptiveAutoUpdateEnabled()) {
+      m_feedsModel->updateAdaptiveUpdateIntervals(results.publishingHistory(), m_globalAutoUpdateInitialInterval,
+                                                  m_adaptiveMinInterval, m_adaptiveMaxInterval);
+    }
+  });
   updateAutoUpdateStatus();
   asyncCacheSaveFinished();
 
@@ -97,6 +106,11 @@ void FeedReader::updateAutoUpdateStatus() {
   m_globalAutoUpdateInitialInterval = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::AutoUpdateInterval)).toInt();
   m_globalAutoUpdateRemainingInterval = m_globalAutoUpdateInitialInterval;
   m_globalAutoUpdateEnabled = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::AutoUpdateEnabled)).toBool();
+  m_adaptiveAutoUpdateEnabled = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::AdaptiveAutoUpdate)).toBool();
+  m_adaptiveMinInterval = qMax(1, qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::AdaptiveAutoUpdateMinInterval)).toInt());
+  m_adaptiveMaxInterval = qMax(m_adaptiveMinInterval,
+                               qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::AdaptiveAutoUpdateMaxInterval)).toInt());
+  m_adaptiveIntervalsOutdated = true;
 
   // Start global auto-update timer if it is not running yet.
   // NOTE: The timer must run even if global auto-update
@@ -124,6 +138,10 @@ int FeedReader::autoUpdateInitialInterval() const {
   return m_globalAutoUpdateInitialInterval;
 }
 
+bool FeedReader::adaptiveAutoUpdateEnabled() const {
+  return m_globalAutoUpdateEnabled && m_adaptiveAutoUpdateEnabled;
+}
+
 void FeedReader::updateAllFeeds() {
   updateFeeds(m_feedsModel->rootItem()->getSubTreeFeeds());
 }
@@ -186,10 +204,16 @@ void FeedReader::executeNextAutoUpdate() {
 
   qDebug("Starting auto-update event, pass %d/%d.", m_globalAutoUpdateRemainingInterval, m_globalAutoUpdateInitialInterval);
 
+  if (adaptiveAutoUpdateEnabled() && m_adaptiveIntervalsOutdated) {
+    m_feedsModel->updateAdaptiveUpdateIntervals(m_globalAutoUpdateInitialInterval, m_adaptiveMinInterval, m_adaptiveMaxInterval);
+    m_adaptiveIntervalsOutdated = false;
+  }
+
   // Pass needed interval data and lets the model decide which feeds
   // should be updated in this pass.
   QList<Feed*> feeds_for_update = m_feedsModel->feedsForScheduledUpdate(m_globalAutoUpdateEnabled &&
-                                                                        m_globalAutoUpdateRemainingInterval == 0);
+                                                                        m_globalAutoUpdateRemainingInterval == 0,
+                                                                        adaptiveAutoUpdateEnabled());
   qApp->feedUpdateLock()->unlock();
 
   if (!feeds_for_update.isEmpty()) {
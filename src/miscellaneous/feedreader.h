@@ -51,6 +51,10 @@ class FeedReader : public QObject {
     int autoUpdateRemainingInterval() const;
     int autoUpdateInitialInterval() const;
 
+    // True if feeds with "default" auto-update strategy are
+    // scheduled according to their publishing rates.
+    bool adaptiveAutoUpdateEnabled() const;
+
   public slots:
 
     // Schedules all feeds from all accounts for update.
@@ -68,7 +72,7 @@ class FeedReader : public QObject {
   signals:
     void feedUpdatesStarted();
     void feedUpdatesFinished(FeedDownloadResults updated_feeds);
-    void feedUpdatesProgress(const Feed* feed, int current, int total);
+    void feedUpdatesProgress(const Feed* feed, int current, int total, int running, int capacity);
 
   private:
     QList<ServiceEntryPoint*> m_feedServices;
@@ -83,6 +87,10 @@ class FeedReader : public QObject {
     bool m_globalAutoUpdateEnabled;
     int m_globalAutoUpdateInitialInterval;
     int m_globalAutoUpdateRemainingInterval;
+    bool m_adaptiveAutoUpdateEnabled;
+    bool m_adaptiveIntervalsOutdated;
+    int m_adaptiveMinInterval;
+    int m_adaptiveMaxInterval;
     QThread* m_feedDownloaderThread;
     FeedDownloader* m_feedDownloader;
     QThread* m_dbCleanerThread;
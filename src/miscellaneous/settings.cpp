@@ -55,6 +55,26 @@ DKEY Feeds::ShowOnlyUnreadFeeds = "show_only_unread_feeds";
 
 DVALUE(bool) Feeds::ShowOnlyUnreadFeedsDef = false;
 
+DKEY Feeds::MaxConcurrentUpdates = "max_concurrent_updates";
+
+DVALUE(int) Feeds::MaxConcurrentUpdatesDef = DEFAULT_CONCURRENT_UPDATES;
+
+DKEY Feeds::MaxConcurrentUpdatesPerHost = "max_concurrent_updates_per_host";
+
+DVALUE(int) Feeds::MaxConcurrentUpdatesPerHostDef = DEFAULT_CONCURRENT_HOST_UPDATES;
+
+DKEY Feeds::AdaptiveAutoUpdate = "adaptive_auto_update";
+
+DVALUE(bool) Feeds::AdaptiveAutoUpdateDef = false;
+
+DKEY Feeds::AdaptiveAutoUpdateMinInterval = "adaptive_auto_update_min_interval";
+
+DVALUE(int) Feeds::AdaptiveAutoUpdateMinIntervalDef = DEFAULT_AUTO_UPDATE_INTERVAL;
+
+DKEY Feeds::AdaptiveAutoUpdateMaxInterval = "adaptive_auto_update_max_interval";
+
+DVALUE(int) Feeds::AdaptiveAutoUpdateMaxIntervalDef = DEFAULT_ADAPTIVE_UPDATE_MAX_INTERVAL;
+
 // Messages.
 DKEY Messages::ID = "messages";
 DKEY Messages::MessageHeadImageHeight = "message_head_image_height";
@@ -74,6 +74,26 @@ namespace Feeds {
   KEY ShowOnlyUnreadFeeds;
 
   VALUE(bool) ShowOnlyUnreadFeedsDef;
+
+  KEY MaxConcurrentUpdates;
+
+  VALUE(int) MaxConcurrentUpdatesDef;
+
+  KEY MaxConcurrentUpdatesPerHost;
+
+  VALUE(int) MaxConcurrentUpdatesPerHostDef;
+
+  KEY AdaptiveAutoUpdate;
+
+  VALUE(bool) AdaptiveAutoUpdateDef;
+
+  KEY AdaptiveAutoUpdateMinInterval;
+
+  VALUE(int) AdaptiveAutoUpdateMinIntervalDef;
+
+  KEY AdaptiveAutoUpdateMaxInterval;
+
+  VALUE(int) AdaptiveAutoUpdateMaxIntervalDef;
 }
 
 // Messages.
@@ -0,0 +1,34 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#include "miscellaneous/stringpool.h"
+
+StringPool::StringPool() : m_strings(QSet<QString>()) {}
+
+QString StringPool::intern(const QString& text) {
+  if (text.isEmpty()) {
+    // Empty strings do not own any data worth sharing.
+    return text;
+  }
+
+  QSet<QString>::const_iterator existing = m_strings.constFind(text);
+
+  if (existing != m_strings.constEnd()) {
+    return *existing;
+  }
+  else {
+    m_strings.insert(text);
+    return text;
+  }
+}
+
+void StringPool::internInPlace(QString& text) {
+  text = intern(text);
+}
+
+int StringPool::size() const {
+  return m_strings.size();
+}
+
+void StringPool::clear() {
+  m_strings.clear();
+}
@@ -0,0 +1,31 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QSet>
+#include <QString>
+
+// Pool of interned strings. Equal strings passed through the
+// pool share one implicitly shared buffer, so values which repeat
+// across many messages (feed IDs, authors, MIME types, ...) are
+// kept in memory only once.
+// NOTE: This class is not thread-safe, use one pool per thread.
+class StringPool {
+  public:
+    explicit StringPool();
+
+    // Returns shared copy of "text".
+    QString intern(const QString& text);
+
+    // Replaces "text" with its shared copy.
+    void internInPlace(QString& text);
+
+    int size() const;
+    void clear();
+
+  private:
+    QSet<QString> m_strings;
+};
+
+#endif // STRINGPOOL_H
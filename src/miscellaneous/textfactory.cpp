@@ -38,23 +38,322 @@ int TextFactory::stringWidth(const QString& string, const QFontMetrics& metrics)
   return width;
 }
 
-QDateTime TextFactory::parseDateTime(const QString& date_time) {
+// Cursor over textual date/time, used by hand-written parsers below.
+class DateTimeTokenizer {
+  public:
+    explicit DateTimeTokenizer(const QString& input) : m_input(input), m_position(0) {}
+
+    bool atEnd() const {
+      return m_position >= m_input.size();
+    }
+
+    QChar peek() const {
+      return atEnd() ? QChar() : m_input.at(m_position);
+    }
+
+    void skipSpaces() {
+      while (!atEnd() && m_input.at(m_position).isSpace()) {
+        m_position++;
+      }
+    }
+
+    bool skip(char character) {
+      if (peek() == QL1C(character)) {
+        m_position++;
+        return true;
+      }
+      else {
+        return false;
+      }
+    }
+
+    // Reads unsigned number with given count of digits.
+    bool readNumber(int min_digits, int max_digits, int& number, int* digits = nullptr) {
+      int count = 0;
+
+      number = 0;
+
+      while (count < max_digits && !atEnd() && m_input.at(m_position).unicode() >= '0' &&
+             m_input.at(m_position).unicode() <= '9') {
+        number = number * 10 + (m_input.at(m_position).unicode() - '0');
+        m_position++;
+        count++;
+      }
+
+      if (digits != nullptr) {
+        *digits = count;
+      }
+
+      return count >= min_digits;
+    }
+
+    // Reads sequence of ASCII letters.
+    QStringRef readWord() {
+      const int start = m_position;
+
+      while (!atEnd() && m_input.at(m_position).unicode() < 128 && m_input.at(m_position).isLetter()) {
+        m_position++;
+      }
+
+      return m_input.midRef(start, m_position - start);
+    }
+
+    // Reads time zone designator and returns its offset from UTC in seconds.
+    // Unknown zone names are considered to be UTC.
+    bool readTimeZone(int& offset) {
+      offset = 0;
+      skipSpaces();
+
+      if (atEnd()) {
+        return true;
+      }
+
+      const QChar sign = peek();
+
+      if (sign == QL1C('+') || sign == QL1C('-')) {
+        m_position++;
+
+        int hours, minutes = 0, digits;
+
+        if (!readNumber(1, 4, hours, &digits)) {
+          return false;
+        }
+
+        if (digits > 2) {
+          // Offset in "hhmm" format.
+          minutes = hours % 100;
+          hours = hours / 100;
+        }
+        else if (skip(':') && !readNumber(2, 2, minutes)) {
+          return false;
+        }
+
+        offset = (hours * 3600 + minutes * 60) * (sign == QL1C('-') ? -1 : 1);
+        return true;
+      }
+
+      const QStringRef zone = readWord();
+
+      if (zone.isEmpty()) {
+        return false;
+      }
+      else if (zone.compare(QL1S("GMT"), Qt::CaseInsensitive) == 0 ||
+               zone.compare(QL1S("UTC"), Qt::CaseInsensitive) == 0 ||
+               zone.compare(QL1S("UT"), Qt::CaseInsensitive) == 0) {
+        // Zone might be followed by offset, like "GMT+02:00".
+        return (peek() != QL1C('+') && peek() != QL1C('-')) || readTimeZone(offset);
+      }
+
+      static const char* const zone_names[] = { "EST", "EDT", "CST", "CDT", "MST", "MDT", "PST", "PDT" };
+      static const int zone_offsets[] = { -5, -4, -6, -5, -7, -6, -8, -7 };
+
+      for (int i = 0; i < 8; i++) {
+        if (zone.compare(QLatin1String(zone_names[i]), Qt::CaseInsensitive) == 0) {
+          offset = zone_offsets[i] * 3600;
+          break;
+        }
+      }
+
+      return true;
+    }
+
+  private:
+    const QString& m_input;
+    int m_position;
+};
+
+QDateTime TextFactory::parseDateTime(const QString& date_time, DateTimeFormat* format) {
+  DateTimeFormat hint = format == nullptr ? UnknownDateTimeFormat : *format;
+  QDateTime result;
+
+  // Try format which succeeded last time first.
+  if ((hint == Rfc822DateTime && parseRfc822DateTime(date_time, result)) ||
+      (hint == Iso8601DateTime && parseIso8601DateTime(date_time, result))) {
+    return result;
+  }
+
+  if (hint != Iso8601DateTime && parseIso8601DateTime(date_time, result)) {
+    hint = Iso8601DateTime;
+  }
+  else if (hint != Rfc822DateTime && parseRfc822DateTime(date_time, result)) {
+    hint = Rfc822DateTime;
+  }
+  else if ((result = parseDateTimeByPatterns(date_time)).isValid()) {
+    hint = OtherDateTimeFormat;
+  }
+
+  if (format != nullptr && result.isValid()) {
+    *format = hint;
+  }
+
+  return result;
+}
+
+bool TextFactory::parseRfc822DateTime(const QString& date_time, QDateTime& result) {
+  // Format is "[Day,] DD Mon YYYY HH:MM[:SS] [Zone]".
+  static const char* const month_names[] = { "jan", "feb", "mar", "apr", "may", "jun",
+                                             "jul", "aug", "sep", "oct", "nov", "dec" };
+  DateTimeTokenizer tokenizer(date_time);
+  int day, month = 0, year, year_digits, hours = 0, minutes = 0, seconds = 0, offset;
+
+  tokenizer.skipSpaces();
+
+  if (tokenizer.peek().isLetter()) {
+    // Skip day of week.
+    tokenizer.readWord();
+    tokenizer.skip(',');
+    tokenizer.skipSpaces();
+  }
+
+  if (!tokenizer.readNumber(1, 2, day)) {
+    return false;
+  }
+
+  tokenizer.skipSpaces();
+  tokenizer.skip('-');
+
+  const QStringRef month_name = tokenizer.readWord();
+
+  if (month_name.size() < 3) {
+    return false;
+  }
+
+  for (int i = 0; i < 12; i++) {
+    if (month_name.left(3).compare(QLatin1String(month_names[i]), Qt::CaseInsensitive) == 0) {
+      month = i + 1;
+      break;
+    }
+  }
+
+  tokenizer.skipSpaces();
+  tokenizer.skip('-');
+
+  if (month == 0 || !tokenizer.readNumber(2, 4, year, &year_digits) || year_digits == 3) {
+    return false;
+  }
+
+  if (year_digits == 2) {
+    // Obsolete two-digit years, see RFC 2822.
+    year += year < 50 ? 2000 : 1900;
+  }
+
+  tokenizer.skipSpaces();
+
+  if (!tokenizer.atEnd()) {
+    if (!tokenizer.readNumber(1, 2, hours) || !tokenizer.skip(':') || !tokenizer.readNumber(2, 2, minutes)) {
+      return false;
+    }
+
+    if (tokenizer.skip(':') && !tokenizer.readNumber(2, 2, seconds)) {
+      return false;
+    }
+
+    if (!tokenizer.readTimeZone(offset)) {
+      return false;
+    }
+  }
+  else {
+    offset = 0;
+  }
+
+  const QDate date(year, month, day);
+  const QTime time(hours, minutes, seconds);
+
+  if (!date.isValid() || !time.isValid()) {
+    return false;
+  }
+
+  result = QDateTime(date, time, Qt::UTC).addSecs(-offset);
+  return true;
+}
+
+bool TextFactory::parseIso8601DateTime(const QString& date_time, QDateTime& result) {
+  // Format is "YYYY[-MM[-DD[THH:MM[:SS[.sss]][Zone]]]]".
+  DateTimeTokenizer tokenizer(date_time);
+  int year, month = 1, day = 1, hours = 0, minutes = 0, seconds = 0, milliseconds = 0, offset = 0;
+
+  tokenizer.skipSpaces();
+
+  if (!tokenizer.readNumber(4, 4, year)) {
+    return false;
+  }
+
+  if (tokenizer.skip('-')) {
+    if (!tokenizer.readNumber(2, 2, month)) {
+      return false;
+    }
+
+    if (tokenizer.skip('-')) {
+      if (!tokenizer.readNumber(2, 2, day)) {
+        return false;
+      }
+
+      if (tokenizer.skip('T') || tokenizer.skip('t') || tokenizer.skip(' ')) {
+        if (!tokenizer.readNumber(2, 2, hours) || !tokenizer.skip(':') || !tokenizer.readNumber(2, 2, minutes)) {
+          return false;
+        }
+
+        if (tokenizer.skip(':')) {
+          if (!tokenizer.readNumber(2, 2, seconds)) {
+            return false;
+          }
+
+          if (tokenizer.skip('.') || tokenizer.skip(',')) {
+            int fraction, digits;
+
+            if (!tokenizer.readNumber(1, 9, fraction, &digits)) {
+              return false;
+            }
+
+            for (milliseconds = fraction; digits > 3; digits--) {
+              milliseconds /= 10;
+            }
+
+            for (; digits < 3; digits++) {
+              milliseconds *= 10;
+            }
+
+            // Skip excessive fraction digits.
+            while (tokenizer.readNumber(1, 9, fraction)) {}
+          }
+        }
+
+        if (tokenizer.skip('Z') || tokenizer.skip('z')) {
+          offset = 0;
+        }
+        else if (!tokenizer.readTimeZone(offset)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  tokenizer.skipSpaces();
+
+  const QDate date(year, month, day);
+  const QTime time(hours, minutes, seconds, milliseconds);
+
+  if (!tokenizer.atEnd() || !date.isValid() || !time.isValid()) {
+    return false;
+  }
+
+  result = QDateTime(date, time, Qt::UTC).addSecs(-offset);
+  return true;
+}
+
+QDateTime TextFactory::parseDateTimeByPatterns(const QString& date_time) {
   const QString input_date = date_time.simplified();
   QDateTime dt;
   QTime time_zone_offset;
   const QLocale locale(QLocale::C);
   bool positive_time_zone_offset = false;
-  QStringList date_patterns;
-
-  date_patterns << QSL("yyyy-MM-ddTHH:mm:ss") << QSL("MMM dd yyyy hh:mm:ss") <<
-    QSL("MMM d yyyy hh:mm:ss") << QSL("ddd, dd MMM yyyy HH:mm:ss") <<
-    QSL("dd MMM yyyy") << QSL("yyyy-MM-dd HH:mm:ss.z") << QSL("yyyy-MM-dd") <<
-    QSL("yyyy") << QSL("yyyy-MM") << QSL("yyyy-MM-dd") << QSL("yyyy-MM-ddThh:mm") <<
-    QSL("yyyy-MM-ddThh:mm:ss");
-  QStringList timezone_offset_patterns;
-
-  timezone_offset_patterns << QSL("+hh:mm") << QSL("-hh:mm") << QSL("+hhmm")
-                           << QSL("-hhmm") << QSL("+hh") << QSL("-hh");
+  static const QStringList date_patterns = QStringList() << QSL("yyyy-MM-ddTHH:mm:ss") << QSL("MMM dd yyyy hh:mm:ss") <<
+                                           QSL("MMM d yyyy hh:mm:ss") << QSL("ddd, dd MMM yyyy HH:mm:ss") <<
+                                           QSL("dd MMM yyyy") << QSL("yyyy-MM-dd HH:mm:ss.z") << QSL("yyyy-MM-dd") <<
+                                           QSL("yyyy") << QSL("yyyy-MM") << QSL("yyyy-MM-dd") << QSL("yyyy-MM-ddThh:mm") <<
+                                           QSL("yyyy-MM-ddThh:mm:ss");
+  static const QStringList timezone_offset_patterns = QStringList() << QSL("+hh:mm") << QSL("-hh:mm") << QSL("+hhmm")
+                                                      << QSL("-hhmm") << QSL("+hh") << QSL("-hh");
 
   if (input_date.size() >= TIMEZONE_OFFSET_LIMIT) {
     foreach (const QString& pattern, timezone_offset_patterns) {
@@ -118,6 +417,19 @@ QString TextFactory::shorten(const QString& input, int text_length_limit) {
   }
 }
 
+quint64 TextFactory::hash64(const QByteArray& data) {
+  const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+  const uchar* end = bytes + data.size();
+  quint64 hash = Q_UINT64_C(14695981039346656037);
+
+  while (bytes < end) {
+    hash ^= *bytes++;
+    hash *= Q_UINT64_C(1099511628211);
+  }
+
+  return hash;
+}
+
 quint64 TextFactory::initializeSecretEncryptionKey() {
   if (s_encryptionKey == 0x0) {
     // Check if file with encryption key exists.
@@ -16,6 +16,14 @@ class TextFactory {
 
   public:
 
+    // Formats of textual date/time representations.
+    enum DateTimeFormat {
+      UnknownDateTimeFormat,
+      Rfc822DateTime,
+      Iso8601DateTime,
+      OtherDateTimeFormat
+    };
+
     // Returns true if lhs is smaller than rhs if case-insensitive string comparison is used.
     static inline bool isCaseInsensitiveLessThan(const QString& lhs, const QString& rhs) {
       return lhs.toLower() < rhs.toLower();
@@ -26,8 +34,16 @@ class TextFactory {
 
     // Tries to parse input textual date/time representation.
     // Returns invalid date/time if processing fails.
+    // If "format" is given, that format is tried first and it is
+    // set to the format which succeeded. Callers which parse many dates
+    // from single source thus usually hit the right parser immediately.
     // NOTE: This method tries to always return time in UTC+00:00.
-    static QDateTime parseDateTime(const QString& date_time);
+    static QDateTime parseDateTime(const QString& date_time, DateTimeFormat* format = nullptr);
+
+    // Parses date/time by trying list of generic patterns, this is
+    // much slower than parseDateTime() and serves as its fallback
+    // for formats which are neither RFC 822 nor ISO 8601.
+    static QDateTime parseDateTimeByPatterns(const QString& date_time);
 
     // Converts 1970-epoch miliseconds to date/time.
     // NOTE: This apparently returns date/time in localtime.
@@ -38,7 +54,12 @@ class TextFactory {
     // Shortens input string according to given length limit.
     static QString shorten(const QString& input, int text_length_limit = TEXT_TITLE_LIMIT);
 
+    // Calculates fast non-cryptographic 64-bit hash (FNV-1a) of given data.
+    static quint64 hash64(const QByteArray& data);
+
   private:
+    static bool parseRfc822DateTime(const QString& date_time, QDateTime& result);
+    static bool parseIso8601DateTime(const QString& date_time, QDateTime& result);
     static quint64 initializeSecretEncryptionKey();
     static quint64 generateSecretEncryptionKey();
     static quint64 s_encryptionKey;
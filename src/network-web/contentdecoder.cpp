@@ -0,0 +1,147 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#include "network-web/contentdecoder.h"
+
+#include "definitions/definitions.h"
+
+#include <brotli/decode.h>
+
+#include <QtGlobal>
+
+ContentDecoder::ContentDecoder(const QByteArray& content_encoding)
+  : m_encoding(Identity), m_error(false), m_rawDeflate(false), m_brotli(nullptr) {
+  const QByteArray encoding = content_encoding.trimmed().toLower();
+
+  memset(&m_zlib, 0, sizeof(m_zlib));
+
+  if (encoding == "gzip" || encoding == "x-gzip") {
+    m_encoding = Gzip;
+
+    // Window bits 15 + 16 tells zlib to expect gzip header.
+    m_error = inflateInit2(&m_zlib, MAX_WBITS + 16) != Z_OK;
+  }
+  else if (encoding == "deflate") {
+    m_encoding = Deflate;
+    m_error = inflateInit2(&m_zlib, MAX_WBITS) != Z_OK;
+  }
+  else if (encoding == "br") {
+    m_encoding = Brotli;
+    m_brotli = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+    m_error = m_brotli == nullptr;
+  }
+  else if (!encoding.isEmpty() && encoding != "identity") {
+    qWarning("Unsupported content encoding '%s', data are used as they are.", encoding.constData());
+  }
+}
+
+ContentDecoder::~ContentDecoder() {
+  if (m_encoding == Gzip || m_encoding == Deflate) {
+    inflateEnd(&m_zlib);
+  }
+
+  if (m_brotli != nullptr) {
+    BrotliDecoderDestroyInstance(m_brotli);
+  }
+}
+
+QByteArray ContentDecoder::acceptedEncodings() {
+  return QByteArrayLiteral("br, gzip, deflate");
+}
+
+bool ContentDecoder::decode(const QByteArray& chunk, QByteArray& output) {
+  if (m_error) {
+    return false;
+  }
+
+  switch (m_encoding) {
+    case Gzip:
+    case Deflate:
+      m_error = !decodeZlib(chunk, output);
+      break;
+
+    case Brotli:
+      m_error = !decodeBrotli(chunk, output);
+      break;
+
+    case Identity:
+    default:
+      output.append(chunk);
+      break;
+  }
+
+  return !m_error;
+}
+
+bool ContentDecoder::decodeZlib(const QByteArray& chunk, QByteArray& output) {
+  char buffer[CONTENT_DECODER_BUFFER_SIZE];
+
+  m_zlib.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(chunk.constData()));
+  m_zlib.avail_in = static_cast<uInt>(chunk.size());
+
+  do {
+    m_zlib.next_out = reinterpret_cast<Bytef*>(buffer);
+    m_zlib.avail_out = sizeof(buffer);
+
+    const int result = inflate(&m_zlib, Z_NO_FLUSH);
+
+    if (result == Z_DATA_ERROR && m_encoding == Deflate && !m_rawDeflate && m_zlib.total_out == 0) {
+      // Some servers send raw deflate data without zlib header.
+      inflateEnd(&m_zlib);
+      m_rawDeflate = true;
+
+      if (inflateInit2(&m_zlib, -MAX_WBITS) != Z_OK) {
+        return false;
+      }
+
+      m_zlib.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(chunk.constData()));
+      m_zlib.avail_in = static_cast<uInt>(chunk.size());
+      continue;
+    }
+
+    if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+      qWarning("Decompression of HTTP data failed with zlib error %d.", result);
+      return false;
+    }
+
+    output.append(buffer, int(sizeof(buffer) - m_zlib.avail_out));
+
+    if (result == Z_STREAM_END) {
+      if (m_zlib.avail_in == 0) {
+        break;
+      }
+
+      // There are more concatenated gzip members.
+      inflateReset(&m_zlib);
+    }
+    else if (result == Z_BUF_ERROR) {
+      // No progress is possible now, wait for more data.
+      break;
+    }
+  } while (m_zlib.avail_in > 0 || m_zlib.avail_out == 0);
+
+  return true;
+}
+
+bool ContentDecoder::decodeBrotli(const QByteArray& chunk, QByteArray& output) {
+  uint8_t buffer[CONTENT_DECODER_BUFFER_SIZE];
+  const uint8_t* next_in = reinterpret_cast<const uint8_t*>(chunk.constData());
+  size_t avail_in = size_t(chunk.size());
+  BrotliDecoderResult result;
+
+  do {
+    uint8_t* next_out = buffer;
+    size_t avail_out = sizeof(buffer);
+
+    result = BrotliDecoderDecompressStream(m_brotli, &avail_in, &next_in, &avail_out, &next_out, nullptr);
+
+    if (result == BROTLI_DECODER_RESULT_ERROR) {
+      qWarning("Decompression of HTTP data failed with brotli error '%s'.",
+               BrotliDecoderErrorString(BrotliDecoderGetErrorCode(m_brotli)));
+      return false;
+    }
+
+    output.append(reinterpret_cast<const char*>(buffer), int(sizeof(buffer) - avail_out));
+  } while (result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT);
+
+  return true;
+}
@@ -0,0 +1,48 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#ifndef CONTENTDECODER_H
+#define CONTENTDECODER_H
+
+#include <QByteArray>
+
+#include <zlib.h>
+
+struct BrotliDecoderStateStruct;
+
+// Decompresses HTTP bodies encoded with "gzip", "deflate" or "br".
+// Data are decoded in chunks as they arrive from network.
+// NOTE: Qt decompresses gzip/deflate on its own only if it negotiates
+// encodings itself. Once we offer brotli too, all decoding is up to us.
+class ContentDecoder {
+  public:
+    explicit ContentDecoder(const QByteArray& content_encoding);
+    virtual ~ContentDecoder();
+
+    // Value for "Accept-Encoding" header.
+    static QByteArray acceptedEncodings();
+
+    // Decodes next chunk of data and appends decoded bytes to "output".
+    // Returns false if data are corrupted.
+    bool decode(const QByteArray& chunk, QByteArray& output);
+
+  private:
+    enum Encoding {
+      Identity,
+      Gzip,
+      Deflate,
+      Brotli
+    };
+
+    bool decodeZlib(const QByteArray& chunk, QByteArray& output);
+    bool decodeBrotli(const QByteArray& chunk, QByteArray& output);
+
+    Q_DISABLE_COPY(ContentDecoder)
+
+    Encoding m_encoding;
+    bool m_error;
+    bool m_rawDeflate;
+    z_stream m_zlib;
+    BrotliDecoderStateStruct* m_brotli;
+};
+
+#endif // CONTENTDECODER_H
@@ -2,25 +2,48 @@
 
 #include "network-web/downloader.h"
 
+#include "miscellaneous/cancellationtoken.h"
 #include "miscellaneous/iofactory.h"
 #include "network-web/silentnetworkaccessmanager.h"
 
+#if defined(USE_BROTLI)
+#include "network-web/contentdecoder.h"
+#endif
+
 #include <QHttpMultiPart>
 #include <QRegularExpression>
 #include <QTimer>
 
 Downloader::Downloader(QObject* parent)
-  : QObject(parent), m_activeReply(nullptr), m_downloadManager(new SilentNetworkAccessManager(this)),
-  m_timer(new QTimer(this)), m_customHeaders(QHash<QByteArray, QByteArray>()), m_inputData(QByteArray()),
-  m_inputMultipartData(nullptr), m_targetProtected(false), m_targetUsername(QString()), m_targetPassword(QString()),
-  m_lastOutputData(QByteArray()), m_lastOutputMultipartData(QList<HttpResponse>()), m_lastOutputError(QNetworkReply::NoError),
-  m_lastContentType(QVariant()) {
+  : QObject(parent), m_activeReply(nullptr), m_cancellationToken(CancellationToken::current()),
+  m_downloadManager(SilentNetworkAccessManager::forCurrentThread()), m_timer(new QTimer(this)),
+  m_contentDecoder(nullptr), m_decodedData(QByteArray()), m_decodeContents(false), m_decodingFailed(false),
+  m_streamContents(false), m_finishedEarly(false), m_customHeaders(QHash<QByteArray, QByteArray>()),
+  m_inputData(QByteArray()), m_inputMultipartData(nullptr), m_targetProtected(false), m_targetUsername(QString()),
+  m_targetPassword(QString()), m_lastOutputData(QByteArray()), m_lastOutputMultipartData(QList<HttpResponse>()),
+  m_lastOutputError(QNetworkReply::NoError), m_lastContentType(QVariant()), m_lastHttpStatusCode(0),
+  m_lastHeaders(QList<QNetworkReply::RawHeaderPair>()) {
   m_timer->setInterval(DOWNLOAD_TIMEOUT);
   m_timer->setSingleShot(true);
   connect(m_timer, &QTimer::timeout, this, &Downloader::cancel);
+
+  if (m_cancellationToken != nullptr) {
+    connect(m_cancellationToken, &CancellationToken::cancelled, this, &Downloader::cancel);
+  }
 }
 
-Downloader::~Downloader() {}
+Downloader::~Downloader() {
+  // Network manager is shared, so running reply
+  // must be terminated manually.
+  if (m_activeReply != nullptr) {
+    m_activeReply->disconnect(this);
+    m_activeReply->abort();
+    m_activeReply->deleteLater();
+    m_activeReply = nullptr;
+  }
+
+  resetContentDecoder();
+}
 
 void Downloader::downloadFile(const QString& url, int timeout, bool protected_contents, const QString& username,
                               const QString& password) {
@@ -62,8 +85,28 @@ void Downloader::manipulateData(const QString& url,
     request.setRawHeader(i.key(), i.value());
   }
 
+#if defined(USE_BROTLI)
+  // Qt is not able to decode brotli, so we negotiate encodings
+  // and decode all compressed contents ourselves.
+  m_decodeContents = !request.hasRawHeader(HTTP_HEADERS_ACCEPT_ENCODING);
+
+  if (m_decodeContents) {
+    request.setRawHeader(HTTP_HEADERS_ACCEPT_ENCODING, ContentDecoder::acceptedEncodings());
+  }
+#else
+  // NOTE: Qt negotiates gzip/deflate and decompresses the data
+  // transparently as long as we do not set "Accept-Encoding" ourselves.
+  m_decodeContents = false;
+#endif
+
+  // Network manager is shared by all downloaders of the thread, so credentials
+  // of one feed must not be reused for other feeds on the same host.
+  // They are given only via "authenticationRequired" signal of the manager.
+  request.setAttribute(QNetworkRequest::AuthenticationReuseAttribute, QNetworkRequest::Manual);
+
   m_inputData = data;
   m_inputMultipartData = multipart_data;
+  m_finishedEarly = false;
 
   // Set url for this request and fire it up.
   m_timer->setInterval(timeout);
@@ -97,6 +140,11 @@ void Downloader::manipulateData(const QString& url,
   else if (operation == QNetworkAccessManager::DeleteOperation) {
     runDeleteRequest(request);
   }
+
+  if (m_cancellationToken != nullptr && m_cancellationToken->isCancelled()) {
+    // Operation is cancelled already, abort it once the caller starts waiting for it.
+    QMetaObject::invokeMethod(this, "cancel", Qt::QueuedConnection);
+  }
 }
 
 void Downloader::finished() {
@@ -122,6 +170,7 @@ void Downloader::finished() {
 
     m_activeReply->deleteLater();
     m_activeReply = nullptr;
+    resetContentDecoder();
 
     if (reply_operation == QNetworkAccessManager::GetOperation) {
       runGetRequest(request);
@@ -144,15 +193,22 @@ void Downloader::finished() {
   else {
     // No redirection is indicated. Final file is obtained in our "reply" object.
     // Read the data into output buffer.
+    const QByteArray contents = readReplyContents(reply);
+
     if (m_inputMultipartData == nullptr) {
-      m_lastOutputData = reply->readAll();
+      m_lastOutputData = contents;
     }
     else {
-      m_lastOutputMultipartData = decodeMultipartAnswer(reply);
+      m_lastOutputMultipartData = decodeMultipartAnswer(reply, contents);
     }
 
     m_lastContentType = reply->header(QNetworkRequest::ContentTypeHeader);
-    m_lastOutputError = reply->error();
+    m_lastHttpStatusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    m_lastHeaders = reply->rawHeaderPairs();
+    m_lastOutputError = m_finishedEarly
+                        ? QNetworkReply::NoError
+                        : (m_decodingFailed ? QNetworkReply::ProtocolFailure : reply->error());
+    resetContentDecoder();
     m_activeReply->deleteLater();
     m_activeReply = nullptr;
 
@@ -172,9 +228,81 @@ void Downloader::progressInternal(qint64 bytes_received, qint64 bytes_total) {
   emit progress(bytes_received, bytes_total);
 }
 
-QList<HttpResponse> Downloader::decodeMultipartAnswer(QNetworkReply* reply) {
-  QByteArray data = reply->readAll();
+void Downloader::readyReadInternal() {
+  readAvailableData(qobject_cast<QNetworkReply*>(sender()));
+}
+
+void Downloader::readAvailableData(QNetworkReply* reply) {
+  if (!m_streamContents) {
+    decodeAvailableData(reply);
+    return;
+  }
+
+  if (reply == nullptr || reply->attribute(QNetworkRequest::RedirectionTargetAttribute).isValid()) {
+    return;
+  }
+
+  const int previous_size = m_decodedData.size();
+
+  if (m_decodeContents) {
+    decodeAvailableData(reply);
+  }
+  else {
+    m_decodedData.append(reply->readAll());
+  }
+
+  if (m_decodedData.size() > previous_size) {
+    emit dataReceived(m_decodedData.mid(previous_size));
+  }
+}
+
+void Downloader::decodeAvailableData(QNetworkReply* reply) {
+#if defined(USE_BROTLI)
+  if (reply == nullptr || m_decodingFailed ||
+      reply->attribute(QNetworkRequest::RedirectionTargetAttribute).isValid()) {
+    // We do not need body of redirections.
+    return;
+  }
+
+  if (m_contentDecoder == nullptr) {
+    m_contentDecoder = new ContentDecoder(reply->rawHeader(HTTP_HEADERS_CONTENT_ENCODING));
+  }
+
+  if (!m_contentDecoder->decode(reply->readAll(), m_decodedData)) {
+    qWarning("Contents of '%s' cannot be decoded, aborting download.", qPrintable(reply->url().toString()));
+    m_decodingFailed = true;
+    reply->abort();
+  }
+#else
+  Q_UNUSED(reply)
+#endif
+}
+
+QByteArray Downloader::readReplyContents(QNetworkReply* reply) {
+  if (!m_decodeContents && !m_streamContents) {
+    return reply->readAll();
+  }
+
+  // Read remaining data and hand over everything obtained so far.
+  readAvailableData(reply);
+
+  QByteArray contents = m_decodedData;
+
+  m_decodedData.clear();
+  return contents;
+}
+
+void Downloader::resetContentDecoder() {
+#if defined(USE_BROTLI)
+  delete m_contentDecoder;
+#endif
 
+  m_contentDecoder = nullptr;
+  m_decodedData.clear();
+  m_decodingFailed = false;
+}
+
+QList<HttpResponse> Downloader::decodeMultipartAnswer(QNetworkReply* reply, const QByteArray& data) {
   IOFactory::writeFile("b.json", data);
 
   if (data.isEmpty()) {
@@ -217,61 +345,61 @@ QList<HttpResponse> Downloader::decodeMultipartAnswer(QNetworkReply* reply) {
   return parts;
 }
 
-void Downloader::runDeleteRequest(const QNetworkRequest& request) {
-  m_timer->start();
-  m_activeReply = m_downloadManager->deleteResource(request);
+void Downloader::setupActiveReply() {
   m_activeReply->setProperty("protected", m_targetProtected);
   m_activeReply->setProperty("username", m_targetUsername);
   m_activeReply->setProperty("password", m_targetPassword);
+
+  if (m_decodeContents || m_streamContents) {
+    connect(m_activeReply, &QNetworkReply::readyRead, this, &Downloader::readyReadInternal);
+  }
+
   connect(m_activeReply, &QNetworkReply::downloadProgress, this, &Downloader::progressInternal);
   connect(m_activeReply, &QNetworkReply::finished, this, &Downloader::finished);
 }
 
+void Downloader::runDeleteRequest(const QNetworkRequest& request) {
+  m_timer->start();
+  m_activeReply = m_downloadManager->deleteResource(request);
+  setupActiveReply();
+}
+
 void Downloader::runPutRequest(const QNetworkRequest& request, const QByteArray& data) {
   m_timer->start();
   m_activeReply = m_downloadManager->put(request, data);
-  m_activeReply->setProperty("protected", m_targetProtected);
-  m_activeReply->setProperty("username", m_targetUsername);
-  m_activeReply->setProperty("password", m_targetPassword);
-  connect(m_activeReply, &QNetworkReply::downloadProgress, this, &Downloader::progressInternal);
-  connect(m_activeReply, &QNetworkReply::finished, this, &Downloader::finished);
+  setupActiveReply();
 }
 
 void Downloader::runPostRequest(const QNetworkRequest& request, QHttpMultiPart* multipart_data) {
   m_timer->start();
   m_activeReply = m_downloadManager->post(request, multipart_data);
-  m_activeReply->setProperty("protected", m_targetProtected);
-  m_activeReply->setProperty("username", m_targetUsername);
-  m_activeReply->setProperty("password", m_targetPassword);
-  connect(m_activeReply, &QNetworkReply::downloadProgress, this, &Downloader::progressInternal);
-  connect(m_activeReply, &QNetworkReply::finished, this, &Downloader::finished);
+  setupActiveReply();
 }
 
 void Downloader::runPostRequest(const QNetworkRequest& request, const QByteArray& data) {
   m_timer->start();
   m_activeReply = m_downloadManager->post(request, data);
-  m_activeReply->setProperty("protected", m_targetProtected);
-  m_activeReply->setProperty("username", m_targetUsername);
-  m_activeReply->setProperty("password", m_targetPassword);
-  connect(m_activeReply, &QNetworkReply::downloadProgress, this, &Downloader::progressInternal);
-  connect(m_activeReply, &QNetworkReply::finished, this, &Downloader::finished);
+  setupActiveReply();
 }
 
 void Downloader::runGetRequest(const QNetworkRequest& request) {
   m_timer->start();
   m_activeReply = m_downloadManager->get(request);
-  m_activeReply->setProperty("protected", m_targetProtected);
-  m_activeReply->setProperty("username", m_targetUsername);
-  m_activeReply->setProperty("password", m_targetPassword);
-
-  connect(m_activeReply, &QNetworkReply::downloadProgress, this, &Downloader::progressInternal);
-  connect(m_activeReply, &QNetworkReply::finished, this, &Downloader::finished);
+  setupActiveReply();
 }
 
 QVariant Downloader::lastContentType() const {
   return m_lastContentType;
 }
 
+int Downloader::lastHttpStatusCode() const {
+  return m_lastHttpStatusCode;
+}
+
+QList<QNetworkReply::RawHeaderPair> Downloader::lastHeaders() const {
+  return m_lastHeaders;
+}
+
 void Downloader::cancel() {
   if (m_activeReply != nullptr) {
     // Download action timed-out, too slow connection or target is not reachable.
@@ -279,6 +407,18 @@ void Downloader::cancel() {
   }
 }
 
+void Downloader::finishEarly() {
+  if (m_activeReply != nullptr && m_activeReply->isRunning()) {
+    // We have all we need, rest of the data is not interesting.
+    m_finishedEarly = true;
+    m_activeReply->abort();
+  }
+}
+
+void Downloader::setStreamContents(bool stream_contents) {
+  m_streamContents = stream_contents;
+}
+
 void Downloader::appendRawHeader(const QByteArray& name, const QByteArray& value) {
   if (!value.isEmpty()) {
     m_customHeaders.insert(name, value);
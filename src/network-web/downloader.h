@@ -12,6 +12,8 @@
 #include <QNetworkReply>
 #include <QSslError>
 
+class CancellationToken;
+class ContentDecoder;
 class SilentNetworkAccessManager;
 class QTimer;
 
@@ -29,10 +31,20 @@ class Downloader : public QObject {
     QNetworkReply::NetworkError lastOutputError() const;
     QList<HttpResponse> lastOutputMultipartData() const;
     QVariant lastContentType() const;
+    int lastHttpStatusCode() const;
+    QList<QNetworkReply::RawHeaderPair> lastHeaders() const;
+
+    // If enabled, each arriving chunk of (decoded) data is
+    // announced via dataReceived() signal.
+    void setStreamContents(bool stream_contents);
 
   public slots:
     void cancel();
 
+    // Stops the download and reports data received so far
+    // as successful result.
+    void finishEarly();
+
     void appendRawHeader(const QByteArray& name, const QByteArray& value);
 
     // Performs asynchronous download of given file. Redirections are handled.
@@ -57,6 +69,7 @@ class Downloader : public QObject {
 
     // Emitted when new progress is known.
     void progress(qint64 bytes_received, qint64 bytes_total);
+    void dataReceived(const QByteArray& chunk);
     void completed(QNetworkReply::NetworkError status, QByteArray contents = QByteArray());
 
   private slots:
@@ -67,8 +80,16 @@ class Downloader : public QObject {
     // Called when progress of downloaded file changes.
     void progressInternal(qint64 bytes_received, qint64 bytes_total);
 
+    // Called when new chunk of data arrives and we decode or stream contents ourselves.
+    void readyReadInternal();
+
   private:
-    QList<HttpResponse> decodeMultipartAnswer(QNetworkReply* reply);
+    void readAvailableData(QNetworkReply* reply);
+    void decodeAvailableData(QNetworkReply* reply);
+    QByteArray readReplyContents(QNetworkReply* reply);
+    void resetContentDecoder();
+    QList<HttpResponse> decodeMultipartAnswer(QNetworkReply* reply, const QByteArray& data);
+    void setupActiveReply();
     void manipulateData(const QString& url, QNetworkAccessManager::Operation operation,
                         const QByteArray& data, QHttpMultiPart* multipart_data,
                         int timeout = DOWNLOAD_TIMEOUT, bool protected_contents = false,
@@ -82,9 +103,21 @@ class Downloader : public QObject {
   private:
     QNetworkReply* m_activeReply;
 
-    QScopedPointer<SilentNetworkAccessManager> m_downloadManager;
+    // Token active in the thread which created this downloader.
+    CancellationToken* m_cancellationToken;
+
+    SilentNetworkAccessManager* m_downloadManager;
     QTimer* m_timer;
 
+    // Decoder of compressed contents, used only if we negotiate
+    // encodings which Qt is not able to decode itself.
+    ContentDecoder* m_contentDecoder;
+    QByteArray m_decodedData;
+    bool m_decodeContents;
+    bool m_decodingFailed;
+    bool m_streamContents;
+    bool m_finishedEarly;
+
     QHash<QByteArray, QByteArray> m_customHeaders;
     QByteArray m_inputData;
     QHttpMultiPart* m_inputMultipartData;
@@ -99,6 +132,8 @@ class Downloader : public QObject {
 
     QNetworkReply::NetworkError m_lastOutputError;
     QVariant m_lastContentType;
+    int m_lastHttpStatusCode;
+    QList<QNetworkReply::RawHeaderPair> m_lastHeaders;
 };
 
 #endif // DOWNLOADER_H
@@ -0,0 +1,115 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#include "network-web/fetchengine.h"
+
+#include "network-web/downloader.h"
+
+#include <QEventLoop>
+
+FetchRequest::FetchRequest(const QString& url, int timeout)
+  : m_url(url), m_timeout(timeout), m_headers(QList<QPair<QByteArray, QByteArray>>()), m_protected(false),
+  m_username(QString()), m_password(QString()) {}
+
+FetchResult::FetchResult()
+  : m_error(QNetworkReply::NoError), m_httpCode(0), m_data(QByteArray()), m_contentType(QVariant()),
+  m_headers(QList<QNetworkReply::RawHeaderPair>()) {}
+
+QByteArray FetchResult::header(const QByteArray& name) const {
+  foreach (const QNetworkReply::RawHeaderPair& header, m_headers) {
+    if (qstricmp(header.first.constData(), name.constData()) == 0) {
+      return header.second;
+    }
+  }
+
+  return QByteArray();
+}
+
+QByteArray FetchResult::charset() const {
+  const QByteArray content_type = m_contentType.toByteArray();
+  const int charset_index = content_type.toLower().indexOf("charset=");
+
+  if (charset_index < 0) {
+    return QByteArray();
+  }
+
+  QByteArray charset = content_type.mid(charset_index + 8);
+  const int end_index = charset.indexOf(';');
+
+  if (end_index >= 0) {
+    charset.truncate(end_index);
+  }
+
+  charset = charset.trimmed();
+
+  if (charset.startsWith('"') || charset.startsWith('\'')) {
+    charset = charset.mid(1, charset.size() - 2);
+  }
+
+  return charset;
+}
+
+FetchEngine::FetchEngine(QObject* parent) : QObject(parent), m_activeRequests(QHash<Downloader*, Callback>()) {}
+
+FetchEngine::~FetchEngine() {
+  qDebug("Destroying FetchEngine instance with %d running requests.", m_activeRequests.size());
+}
+
+int FetchEngine::activeRequests() const {
+  return m_activeRequests.size();
+}
+
+void FetchEngine::fetch(const FetchRequest& request, const Callback& callback) {
+  Downloader* downloader = new Downloader(this);
+
+  foreach (const auto& header, request.m_headers) {
+    if (!header.first.isEmpty()) {
+      downloader->appendRawHeader(header.first, header.second);
+    }
+  }
+
+  m_activeRequests.insert(downloader, callback);
+
+  connect(downloader, &Downloader::completed, this, [this, downloader]() {
+    onDownloaderCompleted(downloader);
+  });
+
+  downloader->manipulateData(request.m_url, QNetworkAccessManager::GetOperation, QByteArray(), request.m_timeout,
+                             request.m_protected, request.m_username, request.m_password);
+}
+
+FetchResult FetchEngine::fetchBlocking(const FetchRequest& request) {
+  FetchEngine engine;
+  FetchResult result;
+  QEventLoop loop;
+
+  engine.fetch(request, [&](const FetchResult& fetched) {
+    result = fetched;
+    loop.quit();
+  });
+
+  loop.exec();
+  return result;
+}
+
+void FetchEngine::abortAll() {
+  foreach (Downloader* downloader, m_activeRequests.keys()) {
+    downloader->cancel();
+  }
+}
+
+void FetchEngine::onDownloaderCompleted(Downloader* downloader) {
+  const Callback callback = m_activeRequests.take(downloader);
+  FetchResult result;
+
+  result.m_error = downloader->lastOutputError();
+  result.m_data = downloader->lastOutputData();
+  result.m_contentType = downloader->lastContentType();
+  result.m_httpCode = downloader->lastHttpStatusCode();
+  result.m_headers = downloader->lastHeaders();
+
+  downloader->deleteLater();
+
+  if (callback) {
+    callback(result);
+  }
+}
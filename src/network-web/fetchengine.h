@@ -0,0 +1,87 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#ifndef FETCHENGINE_H
+#define FETCHENGINE_H
+
+#include <QObject>
+
+#include "definitions/definitions.h"
+
+#include <QHash>
+#include <QList>
+#include <QNetworkReply>
+#include <QPair>
+#include <QVariant>
+
+#include <functional>
+
+class Downloader;
+
+// Represents single GET request handled by FetchEngine.
+class FetchRequest {
+  public:
+    explicit FetchRequest(const QString& url = QString(), int timeout = DOWNLOAD_TIMEOUT);
+
+    QString m_url;
+    int m_timeout;
+    QList<QPair<QByteArray, QByteArray>> m_headers;
+    bool m_protected;
+    QString m_username;
+    QString m_password;
+};
+
+// Represents outcome of single request handled by FetchEngine.
+class FetchResult {
+  public:
+    explicit FetchResult();
+
+    // Returns value of given response header or empty array.
+    QByteArray header(const QByteArray& name) const;
+
+    // Returns "charset" parameter of "Content-Type" header or empty array.
+    QByteArray charset() const;
+
+    QNetworkReply::NetworkError m_error;
+    int m_httpCode;
+    QByteArray m_data;
+    QVariant m_contentType;
+    QList<QNetworkReply::RawHeaderPair> m_headers;
+};
+
+// Performs many downloads at once, all of them are driven
+// by event loop of the thread this object lives in.
+// NOTE: Callbacks are called in the thread of this object.
+class FetchEngine : public QObject {
+  Q_OBJECT
+
+  public:
+    typedef std::function<void(const FetchResult&)> Callback;
+
+    explicit FetchEngine(QObject* parent = nullptr);
+    virtual ~FetchEngine();
+
+    // Number of requests which are in progress right now.
+    int activeRequests() const;
+
+    // Starts asynchronous request, "callback" is called
+    // once the request finishes, fails or is aborted.
+    void fetch(const FetchRequest& request, const Callback& callback);
+
+    // Performs SYNCHRONOUS request, for callers which
+    // do not have their own event loop.
+    static FetchResult fetchBlocking(const FetchRequest& request);
+
+  public slots:
+
+    // Aborts all running requests, their callbacks
+    // get called with "operation canceled" error.
+    void abortAll();
+
+  private:
+    void onDownloaderCompleted(Downloader* downloader);
+
+  private:
+    QHash<Downloader*, Callback> m_activeRequests;
+};
+
+#endif // FETCHENGINE_H
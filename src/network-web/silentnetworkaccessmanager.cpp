@@ -5,10 +5,21 @@
 #include "miscellaneous/application.h"
 
 #include <QAuthenticator>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QNetworkReply>
+#include <QThread>
+#include <QThreadStorage>
 
 Q_GLOBAL_STATIC(SilentNetworkAccessManager, qz_silent_acmanager)
 
+// Managers of non-GUI threads, they are deleted by QThreadStorage
+// when their thread finishes.
+static QThreadStorage<SilentNetworkAccessManager*> s_threadManagers;
+
+static QMutex s_threadManagersMutex;
+static QList<SilentNetworkAccessManager*> s_threadManagersList;
+
 SilentNetworkAccessManager::SilentNetworkAccessManager(QObject* parent)
   : BaseNetworkAccessManager(parent) {
   connect(this, &SilentNetworkAccessManager::authenticationRequired,
@@ -16,6 +27,9 @@ SilentNetworkAccessManager::SilentNetworkAccessManager(QObject* parent)
 }
 
 SilentNetworkAccessManager::~SilentNetworkAccessManager() {
+  QMutexLocker locker(&s_threadManagersMutex);
+
+  s_threadManagersList.removeAll(this);
   qDebug("Destroying SilentNetworkAccessManager instance.");
 }
 
@@ -23,6 +37,34 @@ SilentNetworkAccessManager* SilentNetworkAccessManager::instance() {
   return qz_silent_acmanager();
 }
 
+SilentNetworkAccessManager* SilentNetworkAccessManager::forCurrentThread() {
+  if (qApp == nullptr || QThread::currentThread() == qApp->thread()) {
+    return instance();
+  }
+
+  if (!s_threadManagers.hasLocalData()) {
+    SilentNetworkAccessManager* manager = new SilentNetworkAccessManager();
+    QMutexLocker locker(&s_threadManagersMutex);
+
+    s_threadManagers.setLocalData(manager);
+    s_threadManagersList.append(manager);
+    qDebug().nospace() << "Created shared network manager for thread \'" << QThread::currentThreadId() << "\'.";
+  }
+
+  return s_threadManagers.localData();
+}
+
+void SilentNetworkAccessManager::reloadSettingsOfAllInstances() {
+  instance()->loadSettings();
+
+  QMutexLocker locker(&s_threadManagersMutex);
+
+  foreach (SilentNetworkAccessManager* manager, s_threadManagersList) {
+    // Managers live in other threads, let them reload there.
+    QMetaObject::invokeMethod(manager, "loadSettings", Qt::QueuedConnection);
+  }
+}
+
 void SilentNetworkAccessManager::onAuthenticationRequired(QNetworkReply* reply, QAuthenticator* authenticator) {
   if (reply->property("protected").toBool()) {
     // This feed contains authentication information, it is good.
@@ -21,6 +21,14 @@ class SilentNetworkAccessManager : public BaseNetworkAccessManager {
     // Returns pointer to global silent network manager
     static SilentNetworkAccessManager* instance();
 
+    // Returns network manager shared by all requests made from
+    // the calling thread, so that keep-alive connections, TLS sessions
+    // and DNS cache are reused. Manager is destroyed when thread exits.
+    static SilentNetworkAccessManager* forCurrentThread();
+
+    // Reloads settings of global and all per-thread managers.
+    static void reloadSettingsOfAllInstances();
+
   public slots:
 
     // This cannot do any GUI stuff.
@@ -7,7 +7,6 @@
 
 #include <QDesktopServices>
 #include <QProcess>
-#include <QRegExp>
 #include <QUrl>
 
 #if defined (USE_WEBENGINE)
@@ -15,7 +14,7 @@
 #endif
 
 WebFactory::WebFactory(QObject* parent)
-  : QObject(parent), m_escapes(QMap<QString, QString>()), m_deEscapes(QMap<QString, QString>()) {
+  : QObject(parent) {
 #if defined (USE_WEBENGINE)
   m_engineSettings = nullptr;
 #endif
@@ -67,43 +66,218 @@ bool WebFactory::openUrlInExternalBrowser(const QString& url) const {
 }
 
 QString WebFactory::stripTags(QString text) {
-  return text.remove(QRegExp(QSL("<[^>]*>")));
+  // Runs of plain text are skipped with QString::indexOf()
+  // which is vectorized, text is compacted in place.
+  int tag_start = text.indexOf(QL1C('<'));
+
+  if (tag_start < 0) {
+    return text;
+  }
+
+  const int size = text.size();
+  QChar* data = text.data();
+  int output_position = tag_start;
+
+  while (tag_start >= 0) {
+    const int tag_end = text.indexOf(QL1C('>'), tag_start + 1);
+
+    if (tag_end < 0) {
+      // Tag is not closed, keep the rest of text as it is.
+      break;
+    }
+
+    const int next_tag_start = text.indexOf(QL1C('<'), tag_end + 1);
+    const int text_end = next_tag_start < 0 ? size : next_tag_start;
+    const int text_length = text_end - tag_end - 1;
+
+    memmove(data + output_position, data + tag_end + 1, sizeof(QChar) * size_t(text_length));
+    output_position += text_length;
+    tag_start = next_tag_start;
+  }
+
+  if (tag_start >= 0) {
+    memmove(data + output_position, data + tag_start, sizeof(QChar) * size_t(size - tag_start));
+    output_position += size - tag_start;
+  }
+
+  text.truncate(output_position);
+  return text;
 }
 
 QString WebFactory::escapeHtml(const QString& html) {
-  if (m_escapes.isEmpty()) {
-    generateEscapes();
+  int entity_start = html.indexOf(QL1C('&'));
+
+  if (entity_start < 0) {
+    return html;
   }
 
-  QString output = html;
+  // Decoded text is never longer than the original one.
+  const int size = html.size();
+  const QChar* input = html.constData();
+  QString output(size, Qt::Uninitialized);
+  QChar* data = output.data();
+  int output_position = 0, position = 0;
+
+  while (entity_start >= 0) {
+    memcpy(data + output_position, input + position, sizeof(QChar) * size_t(entity_start - position));
+    output_position += entity_start - position;
+    position = entity_start;
+
+    // Entities are short, do not look for semicolon too far.
+    int entity_end = entity_start + 1;
+
+    while (entity_end < size && entity_end - entity_start <= 10 && input[entity_end] != QL1C(';') &&
+           input[entity_end] != QL1C('&')) {
+      entity_end++;
+    }
+
+    const uint code_point = entity_end < size && input[entity_end] == QL1C(';') ?
+                            decodeEntity(input + entity_start + 1, entity_end - entity_start - 1) : 0;
 
-  QMapIterator<QString, QString> i(m_escapes);
+    if (code_point == 0) {
+      data[output_position++] = input[position++];
+    }
+    else {
+      if (QChar::requiresSurrogates(code_point)) {
+        data[output_position++] = QChar(QChar::highSurrogate(code_point));
+        data[output_position++] = QChar(QChar::lowSurrogate(code_point));
+      }
+      else {
+        data[output_position++] = QChar(code_point);
+      }
+
+      position = entity_end + 1;
+    }
 
-  while (i.hasNext()) {
-    i.next();
-    output = output.replace(i.key(), i.value());
+    entity_start = html.indexOf(QL1C('&'), position);
   }
 
+  memcpy(data + output_position, input + position, sizeof(QChar) * size_t(size - position));
+  output_position += size - position;
+  output.truncate(output_position);
   return output;
 }
 
 QString WebFactory::deEscapeHtml(const QString& text) {
-  if (m_deEscapes.isEmpty()) {
-    generateDeescapes();
-  }
+  const int size = text.size();
+  const QChar* input = text.constData();
+  QString output;
+  int position = 0;
+
+  for (int i = 0; i < size; i++) {
+    const char* entity;
+
+    switch (input[i].unicode()) {
+      case '<':
+        entity = "&lt;";
+        break;
+
+      case '>':
+        entity = "&gt;";
+        break;
 
-  QString output = text;
+      case '&':
+        entity = "&amp;";
+        break;
 
-  QMapIterator<QString, QString> i(m_deEscapes);
+      case '"':
+        entity = "&quot;";
+        break;
 
-  while (i.hasNext()) {
-    i.next();
-    output = output.replace(i.key(), i.value());
+      case '\'':
+        entity = "&#039;";
+        break;
+
+      case 0x00B1:
+        entity = "&plusmn;";
+        break;
+
+      case 0x00D7:
+        entity = "&times;";
+        break;
+
+      default:
+        continue;
+    }
+
+    if (output.isNull()) {
+      // Reserve some space for entities so that we do not reallocate often.
+      output.reserve(size + size / 8 + 16);
+    }
+
+    output.append(input + position, i - position);
+    output.append(QLatin1String(entity));
+    position = i + 1;
+  }
+
+  if (position == 0) {
+    return text;
   }
 
+  output.append(input + position, size - position);
   return output;
 }
 
+uint WebFactory::decodeEntity(const QChar* input, int size) {
+  if (size >= 2 && input[0] == QL1C('#')) {
+    // Numeric entity, decimal or hexadecimal.
+    const bool hexadecimal = input[1] == QL1C('x') || input[1] == QL1C('X');
+    uint code_point = 0;
+
+    for (int i = hexadecimal ? 2 : 1; i < size; i++) {
+      const ushort character = input[i].unicode();
+      int digit;
+
+      if (character >= '0' && character <= '9') {
+        digit = character - '0';
+      }
+      else if (hexadecimal && character >= 'a' && character <= 'f') {
+        digit = character - 'a' + 10;
+      }
+      else if (hexadecimal && character >= 'A' && character <= 'F') {
+        digit = character - 'A' + 10;
+      }
+      else {
+        return 0;
+      }
+
+      code_point = code_point * (hexadecimal ? 16 : 10) + uint(digit);
+
+      if (code_point > 0x10FFFF) {
+        return 0;
+      }
+    }
+
+    return (code_point >= 0xD800 && code_point <= 0xDFFF) ? 0 : code_point;
+  }
+
+  static const struct {
+    const char* m_name;
+    ushort m_character;
+  } entities[] = {
+    { "amp", '&' }, { "lt", '<' }, { "gt", '>' }, { "quot", '"' }, { "apos", '\'' },
+    { "nbsp", ' ' }, { "plusmn", 0x00B1 }, { "times", 0x00D7 }, { "copy", 0x00A9 }, { "reg", 0x00AE },
+    { "deg", 0x00B0 }, { "middot", 0x00B7 }, { "laquo", 0x00AB }, { "raquo", 0x00BB }, { "ndash", 0x2013 },
+    { "mdash", 0x2014 }, { "lsquo", 0x2018 }, { "rsquo", 0x2019 }, { "ldquo", 0x201C }, { "rdquo", 0x201D },
+    { "bull", 0x2022 }, { "hellip", 0x2026 }, { "euro", 0x20AC }, { "trade", 0x2122 }
+  };
+
+  for (size_t i = 0; i < sizeof(entities) / sizeof(entities[0]); i++) {
+    const char* name = entities[i].m_name;
+    int j = 0;
+
+    while (j < size && name[j] != '\0' && input[j] == QL1C(name[j])) {
+      j++;
+    }
+
+    if (j == size && name[j] == '\0') {
+      return entities[i].m_character;
+    }
+  }
+
+  return 0;
+}
+
 QString WebFactory::toSecondLevelDomain(const QUrl& url) {
   const QString top_level_domain = url.topLevelDomain();
   const QString url_host = url.host();
@@ -194,24 +368,3 @@ QAction* WebFactory::createEngineSettingsAction(const QString& title, QWebEngine
 }
 
 #endif
-
-void WebFactory::generateEscapes() {
-  m_escapes[QSL("&lt;")] = QL1C('<');
-  m_escapes[QSL("&gt;")] = QL1C('>');
-  m_escapes[QSL("&amp;")] = QL1C('&');
-  m_escapes[QSL("&quot;")] = QL1C('\"');
-  m_escapes[QSL("&nbsp;")] = QL1C(' ');
-  m_escapes[QSL("&plusmn;")] = QSL("±");
-  m_escapes[QSL("&times;")] = QSL("×");
-  m_escapes[QSL("&#039;")] = QL1C('\'');
-}
-
-void WebFactory::generateDeescapes() {
-  m_deEscapes[QSL("<")] = QSL("&lt;");
-  m_deEscapes[QSL(">")] = QSL("&gt;");
-  m_deEscapes[QSL("&")] = QSL("&amp;");
-  m_deEscapes[QSL("\"")] = QSL("&quot;");
-  m_deEscapes[QSL("±")] = QSL("&plusmn;");
-  m_deEscapes[QSL("×")] = QSL("&times;");
-  m_deEscapes[QSL("\'")] = QSL("&#039;");
-}
@@ -7,8 +7,6 @@
 
 #include "core/messagesmodel.h"
 
-#include <QMap>
-
 #if defined (USE_WEBENGINE)
 #include <QWebEngineSettings>
 #endif
@@ -27,7 +25,9 @@ class WebFactory : public QObject {
     // Strips "<....>" (HTML, XML) tags from given text.
     QString stripTags(QString text);
 
-    // HTML entity escaping.
+    // HTML entity escaping, "escapeHtml" decodes named and numeric
+    // entities, "deEscapeHtml" encodes special characters into entities.
+    // NOTE: All these methods process text in single pass.
     QString escapeHtml(const QString& html);
     QString deEscapeHtml(const QString& text);
 
@@ -52,11 +52,10 @@ class WebFactory : public QObject {
 #endif
 
   private:
-    void generateEscapes();
-    void generateDeescapes();
 
-    QMap<QString, QString> m_escapes;
-    QMap<QString, QString> m_deEscapes;
+    // Decodes name of entity (without "&" and ";") into Unicode
+    // code point, returns 0 if entity is unknown.
+    static uint decodeEntity(const QChar* input, int size);
 
 #if defined (USE_WEBENGINE)
     QAction* m_engineSettings;
@@ -2,23 +2,32 @@
 
 #include "services/abstract/feed.h"
 
+#include "core/messagesanitizer.h"
 #include "definitions/definitions.h"
 #include "miscellaneous/application.h"
+#include "miscellaneous/cancellationtoken.h"
 #include "miscellaneous/databasequeries.h"
 #include "miscellaneous/feedreader.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/mutex.h"
+#include "miscellaneous/stringpool.h"
 #include "miscellaneous/textfactory.h"
 #include "services/abstract/cacheforserviceroot.h"
 #include "services/abstract/recyclebin.h"
 #include "services/abstract/serviceroot.h"
 
+#include <QDateTime>
 #include <QThread>
 
+#include <utility>
+
 Feed::Feed(RootItem* parent)
   : RootItem(parent), m_url(QString()), m_status(Normal), m_autoUpdateType(DefaultAutoUpdate),
-  m_autoUpdateInitialInterval(DEFAULT_AUTO_UPDATE_INTERVAL), m_autoUpdateRemainingInterval(DEFAULT_AUTO_UPDATE_INTERVAL),
-  m_totalCount(0), m_unreadCount(0) {
+  m_autoUpdateInitialInterval(DEFAULT_AUTO_UPDATE_INTERVAL),
+  m_autoUpdateRemainingInterval(DEFAULT_AUTO_UPDATE_INTERVAL), m_adaptiveUpdateInterval(DEFAULT_AUTO_UPDATE_INTERVAL),
+  m_consecutiveFailures(0), m_nextUpdateAttempt(0), m_totalCount(0), m_unreadCount(0), m_fetchResult(FetchResult()),
+  m_hasFetchResult(false), m_cancellationToken(nullptr), m_contentsUnchanged(false), m_fetchStateSaved(false),
+  m_obtainedMessages(MessageBatch()) {
   setKind(RootItemKind::Feed);
   setAutoDelete(false);
 }
@@ -42,7 +51,10 @@ Feed::Feed(const QSqlRecord& record) : Feed(nullptr) {
   qDebug("Custom ID of feed when loading from DB is '%s'.", qPrintable(customId()));
 }
 
-Feed::Feed(const Feed& other) : RootItem(other) {
+Feed::Feed(const Feed& other)
+  : RootItem(other), m_adaptiveUpdateInterval(other.adaptiveUpdateInterval()),
+  m_consecutiveFailures(other.m_consecutiveFailures), m_nextUpdateAttempt(other.m_nextUpdateAttempt),
+  m_hasFetchResult(false), m_cancellationToken(nullptr), m_contentsUnchanged(false), m_fetchStateSaved(false) {
   setKind(RootItemKind::Feed);
   setAutoDelete(false);
 
@@ -132,6 +144,56 @@ void Feed::setAutoUpdateRemainingInterval(int auto_update_remaining_interval) {
   m_autoUpdateRemainingInterval = auto_update_remaining_interval;
 }
 
+int Feed::adaptiveUpdateInterval() const {
+  return m_adaptiveUpdateInterval;
+}
+
+void Feed::setAdaptiveUpdateInterval(int adaptive_update_interval) {
+  m_adaptiveUpdateInterval = adaptive_update_interval;
+
+  if (autoUpdateType() == DefaultAutoUpdate && m_autoUpdateRemainingInterval > adaptive_update_interval) {
+    // Feed got more active, do not let it wait for its old interval.
+    m_autoUpdateRemainingInterval = adaptive_update_interval;
+  }
+}
+
+int Feed::consecutiveFailures() const {
+  return m_consecutiveFailures;
+}
+
+bool Feed::isBackingOff() const {
+  return m_nextUpdateAttempt > QDateTime::currentMSecsSinceEpoch();
+}
+
+bool Feed::isCircuitOpen() const {
+  return m_consecutiveFailures >= FEED_CIRCUIT_BREAKER_FAILURES;
+}
+
+void Feed::registerUpdateSuccess() {
+  m_consecutiveFailures = 0;
+  m_nextUpdateAttempt = 0;
+}
+
+void Feed::registerUpdateFailure(qint64 retry_after) {
+  m_consecutiveFailures++;
+
+  // Once circuit is open, feed waits for maximal delay.
+  const qint64 delay = isCircuitOpen() ? qint64(FEED_BACKOFF_MAX_INTERVAL) * 60000 : backoffDelay(m_consecutiveFailures);
+
+  m_nextUpdateAttempt = QDateTime::currentMSecsSinceEpoch() + qMax(delay, retry_after);
+  qDebug("Feed '%s' failed %d time(s) in a row, next auto-update in %lld seconds.",
+         qPrintable(customId()), m_consecutiveFailures, qMax(delay, retry_after) / 1000);
+}
+
+qint64 Feed::backoffDelay(int failures) {
+  const qint64 max_delay = qint64(FEED_BACKOFF_MAX_INTERVAL) * 60000;
+  const qint64 delay = qMin(max_delay, (qint64(FEED_BACKOFF_BASE_INTERVAL) * 60000) << qBound(0, failures - 1, 20));
+
+  // Half of the delay is random, so that many feeds which failed
+  // at the same time do not retry at the same time.
+  return delay / 2 + qint64((delay / 2) * (double(qrand()) / RAND_MAX));
+}
+
 Feed::Status Feed::status() const {
   return m_status;
 }
@@ -152,7 +214,7 @@ void Feed::updateCounts(bool including_total_count) {
   bool is_main_thread = QThread::currentThread() == qApp->thread();
   QSqlDatabase database = is_main_thread ?
                           qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings) :
-                          qApp->database()->connection(QSL("feed_upd"), DatabaseFactory::FromSettings);
+                          qApp->database()->connection(QSL(APP_DB_WRITER_CONNECTION), DatabaseFactory::FromSettings);
   int account_id = getParentServiceRoot()->accountId();
 
   if (including_total_count) {
@@ -168,30 +230,99 @@ void Feed::run() {
                      << QThread::currentThreadId() << "\'.";
 
   bool error_during_obtaining = false;
+  CancellationToken no_cancellation;
+  CancellationToken* token = m_cancellationToken != nullptr ? m_cancellationToken : &no_cancellation;
+
+  setContentsUnchanged(false);
+
+  if (token->isCancelled()) {
+    // Update was stopped before this feed got its turn.
+    FetchResult ignored;
+
+    takeFetchResult(ignored);
+    m_obtainedMessages = MessageBatch();
+    emit messagesObtained();
+    return;
+  }
 
-  QList<Message> msgs = obtainNewMessages(&error_during_obtaining);
+  // All downloads made from now on in this thread get aborted with the token.
+  CancellationToken::setCurrent(token);
+
+  QList<Message> msgs = obtainNewMessages(&error_during_obtaining, *token);
+
+  CancellationToken::setCurrent(nullptr);
 
   qDebug().nospace() << "Downloaded " << msgs.size() << " messages for feed ID "
                      << customId() << " URL: " << url() << " title: " << title() << " in thread: \'"
                      << QThread::currentThreadId() << "\'.";
 
-  // Now, do some general operations on messages (tweak encoding etc.).
+  // Now, do some general operations on messages (tweak encoding,
+  // remove newlines from titles etc.). Repeated values are interned so that
+  // messages queued for storing do not keep thousands of equal copies alive.
+  StringPool string_pool;
+
   for (int i = 0; i < msgs.size(); i++) {
-    // Also, make sure that HTML encoding, encoding of special characters, etc., is fixed.
-    msgs[i].m_contents = QUrl::fromPercentEncoding(msgs[i].m_contents.toUtf8());
-    msgs[i].m_author = msgs[i].m_author.toUtf8();
+    MessageSanitizer::sanitize(msgs[i]);
+    msgs[i].internStrings(string_pool);
+  }
+
+  // Batch is picked up by the receiver, list is moved so that
+  // its messages stay unshared and nothing gets copied.
+  m_obtainedMessages = MessageBatch(std::move(msgs), error_during_obtaining);
+  emit messagesObtained();
+}
+
+bool Feed::prepareFetch(FetchRequest& request) const {
+  Q_UNUSED(request)
+
+  // By default, feeds download their data synchronously in "run()".
+  return false;
+}
 
-    // Sanitize title. Remove newlines etc.
-    msgs[i].m_title = QUrl::fromPercentEncoding(msgs[i].m_title.toUtf8())
+void Feed::setFetchResult(const FetchResult& result) {
+  m_fetchResult = result;
+  m_hasFetchResult = true;
+}
 
-                      // Replace all continuous white space.
-                      .replace(QRegExp(QSL("[\\s]{2,}")), QSL(" "))
+void Feed::setCancellationToken(CancellationToken* token) {
+  m_cancellationToken = token;
+}
 
-                      // Remove all newlines and leading white space.
-                      .remove(QRegExp(QSL("([\\n\\r])|(^\\s)")));
+bool Feed::takeFetchResult(FetchResult& result) {
+  if (!m_hasFetchResult) {
+    return false;
   }
 
-  emit messagesObtained(msgs, error_during_obtaining);
+  result = m_fetchResult;
+  m_fetchResult = FetchResult();
+  m_hasFetchResult = false;
+  return true;
+}
+
+MessageBatch Feed::takeObtainedMessages() {
+  return std::move(m_obtainedMessages);
+}
+
+bool Feed::contentsUnchanged() const {
+  return m_contentsUnchanged;
+}
+
+void Feed::setContentsUnchanged(bool unchanged) {
+  m_contentsUnchanged = unchanged;
+}
+
+bool Feed::saveFetchState(QSqlDatabase& database) {
+  Q_UNUSED(database)
+  return true;
+}
+
+void Feed::applyFetchState() {}
+
+void Feed::commitFetchState() {
+  if (m_fetchStateSaved) {
+    m_fetchStateSaved = false;
+    applyFetchState();
+  }
 }
 
 bool Feed::cleanMessages(bool clean_read_only) {
@@ -209,13 +340,17 @@ bool Feed::markAsReadUnread(RootItem::ReadStatus status) {
   return service->markFeedsReadUnread(QList<Feed*>() << this, status);
 }
 
-int Feed::updateMessages(const QList<Message>& messages, bool error_during_obtaining) {
+int Feed::updateMessages(QList<Message>& messages, bool error_during_obtaining, bool external_transaction) {
   QList<RootItem*> items_to_update;
   int updated_messages = 0;
   bool is_main_thread = QThread::currentThread() == qApp->thread();
+  const bool in_external_transaction = external_transaction && !is_main_thread;
 
   qDebug("Updating messages in DB. Main thread: '%s'.", qPrintable(is_main_thread ? "true" : "false"));
 
+  // State stored by previous call is forgotten, its transaction was either committed or rolled back.
+  m_fetchStateSaved = false;
+
   bool anything_updated = false;
   bool ok = true;
 
@@ -226,9 +361,10 @@ int Feed::updateMessages(const QList<Message>& messages, bool error_during_obtai
     int account_id = getParentServiceRoot()->accountId();
     QSqlDatabase database = is_main_thread ?
                             qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings) :
-                            qApp->database()->connection(QSL("feed_upd"), DatabaseFactory::FromSettings);
+                            qApp->database()->connection(QSL(APP_DB_WRITER_CONNECTION), DatabaseFactory::FromSettings);
 
-    updated_messages = DatabaseQueries::updateMessages(database, messages, custom_id, account_id, url(), &anything_updated, &ok);
+    updated_messages = DatabaseQueries::updateMessages(database, messages, custom_id, account_id, url(),
+                                                       &anything_updated, &ok, in_external_transaction);
   }
   else {
     qWarning("There are no messages for update.");
@@ -238,6 +374,19 @@ int Feed::updateMessages(const QList<Message>& messages, bool error_during_obtai
     setStatus(updated_messages > 0 ? NewMessages : Normal);
     updateCounts(true);
 
+    if (!error_during_obtaining) {
+      QSqlDatabase database = is_main_thread ?
+                              qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings) :
+                              qApp->database()->connection(QSL(APP_DB_WRITER_CONNECTION), DatabaseFactory::FromSettings);
+
+      m_fetchStateSaved = saveFetchState(database);
+
+      if (!in_external_transaction) {
+        // State is already committed.
+        commitFetchState();
+      }
+    }
+
     if (getParentServiceRoot()->recycleBin() != nullptr && anything_updated) {
       getParentServiceRoot()->recycleBin()->updateCounts(true);
       items_to_update.append(getParentServiceRoot()->recycleBin());
@@ -269,10 +418,19 @@ QString Feed::getAutoUpdateStatusDescription() const {
 
     case DefaultAutoUpdate:
 
-      //: Describes feed auto-update status.
-      auto_update_string = tr("uses global settings (%n minute(s) to next auto-update)",
-                              0,
-                              qApp->feedReader()->autoUpdateRemainingInterval());
+      if (qApp->feedReader()->adaptiveAutoUpdateEnabled()) {
+        //: Describes feed auto-update status.
+        auto_update_string = tr("adapts to publishing rate of the feed (%n minute(s) to next auto-update)",
+                                0,
+                                autoUpdateRemainingInterval());
+      }
+      else {
+        //: Describes feed auto-update status.
+        auto_update_string = tr("uses global settings (%n minute(s) to next auto-update)",
+                                0,
+                                qApp->feedReader()->autoUpdateRemainingInterval());
+      }
+
       break;
 
     case SpecificAutoUpdate:
@@ -305,7 +463,25 @@ QString Feed::getStatusDescription() const {
   }
 }
 
+QString Feed::getHealthDescription() const {
+  if (m_consecutiveFailures <= 0) {
+    return QString();
+  }
+
+  const int minutes = int(qMax(Q_INT64_C(0), m_nextUpdateAttempt - QDateTime::currentMSecsSinceEpoch()) / 60000);
+
+  if (isCircuitOpen()) {
+    return tr("suspended after %n failure(s) in a row, next attempt in %1 minute(s)", 0, m_consecutiveFailures).arg(minutes);
+  }
+  else {
+    return tr("failed %n time(s) in a row, next attempt in %1 minute(s)", 0, m_consecutiveFailures).arg(minutes);
+  }
+}
+
 QString Feed::additionalTooltip() const {
+  const QString health = getHealthDescription();
+
   return tr("Auto-update status: %1\n"
-            "Status: %2").arg(getAutoUpdateStatusDescription(), getStatusDescription());
+            "Status: %2").arg(getAutoUpdateStatusDescription(),
+                              health.isEmpty() ? getStatusDescription() : getStatusDescription() + QSL(" (") + health + QSL(")"));
 }
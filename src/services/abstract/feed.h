@@ -6,10 +6,15 @@
 #include "services/abstract/rootitem.h"
 
 #include "core/message.h"
+#include "core/messagebatch.h"
+#include "network-web/fetchengine.h"
 
 #include <QRunnable>
+#include <QSqlDatabase>
 #include <QVariant>
 
+class CancellationToken;
+
 // Base class for "feed" nodes.
 class Feed : public RootItem, public QRunnable {
   Q_OBJECT
@@ -62,33 +67,99 @@ class Feed : public RootItem, public QRunnable {
     int autoUpdateRemainingInterval() const;
     void setAutoUpdateRemainingInterval(int auto_update_remaining_interval);
 
+    // Interval estimated from publishing rate of the feed, it is
+    // used for "default" auto-update strategy if adaptive auto-update is enabled.
+    int adaptiveUpdateInterval() const;
+    void setAdaptiveUpdateInterval(int adaptive_update_interval);
+
     Status status() const;
     void setStatus(const Status& status);
 
     QString url() const;
     void setUrl(const QString& url);
 
+    // Health of the feed. Feeds which keep failing are not auto-updated
+    // for exponentially growing (randomized) time. After
+    // FEED_CIRCUIT_BREAKER_FAILURES failures in a row the circuit "opens"
+    // and feed is attempted only once per FEED_BACKOFF_MAX_INTERVAL.
+    int consecutiveFailures() const;
+    bool isBackingOff() const;
+    bool isCircuitOpen() const;
+    void registerUpdateSuccess();
+
+    // "retry_after" is delay in msecs requested by the server, if any.
+    void registerUpdateFailure(qint64 retry_after = 0);
+
+    // Returns randomized delay in msecs before next attempt
+    // after "failures" failures in a row.
+    static qint64 backoffDelay(int failures);
+
     // Runs update in thread (thread pooled).
     void run();
 
+    // Feeds which are able to download their data without
+    // blocking fill the request and return true. Data are then
+    // downloaded by FeedDownloader's fetch engine, handed over via
+    // setFetchResult() and "run()" just processes them.
+    virtual bool prepareFetch(FetchRequest& request) const;
+    void setFetchResult(const FetchResult& result);
+
+    // Token which aborts "run()" once it is cancelled.
+    void setCancellationToken(CancellationToken* token);
+
+    // Returns true if last "run()" found out that feed contents did not
+    // change since previous update, so there is nothing to store.
+    bool contentsUnchanged() const;
+
+    // Hands over messages obtained by last "run()",
+    // call it once "messagesObtained()" is emitted.
+    MessageBatch takeObtainedMessages();
+
     bool markAsReadUnread(ReadStatus status);
     bool cleanMessages(bool clean_read_only);
 
   public slots:
     void updateCounts(bool including_total_count);
-    int updateMessages(const QList<Message>& messages, bool error_during_obtaining);
+
+    // Stores messages into DB. If "external_transaction" is true, then messages are
+    // stored within transaction which is managed by caller on "feed_upd" connection.
+    // NOTE: Messages might get adjusted in place (relative URLs etc.).
+    int updateMessages(QList<Message>& messages, bool error_during_obtaining, bool external_transaction = false);
+
+    // Starts using download state stored by last updateMessages() call. Caller which
+    // manages external transaction calls this once the transaction is committed.
+    void commitFetchState();
 
   protected:
     QString getAutoUpdateStatusDescription() const;
     QString getStatusDescription() const;
+    QString getHealthDescription() const;
+
+    // Hands over data prefetched via setFetchResult(), returns
+    // false if there are no such data.
+    bool takeFetchResult(FetchResult& result);
+    void setContentsUnchanged(bool unchanged);
+
+    // Called once messages from last update are successfully stored,
+    // so that feed can persist its download state (HTTP validators etc.).
+    // Returns false if the state was not stored.
+    virtual bool saveFetchState(QSqlDatabase& database);
+
+    // Called once stored download state is committed to DB,
+    // feed can then use it for next updates.
+    virtual void applyFetchState();
 
   signals:
-    void messagesObtained(QList<Message> messages, bool error_during_obtaining);
+    // Emitted once "run()" finishes, messages are then picked up
+    // via "takeObtainedMessages()", so that they are not copied
+    // into event queue.
+    void messagesObtained();
 
   private:
 
     // Performs synchronous obtaining of new messages for this feed.
-    virtual QList<Message> obtainNewMessages(bool* error_during_obtaining) = 0;
+    // Implementations should return as soon as possible once "token" is cancelled.
+    virtual QList<Message> obtainNewMessages(bool* error_during_obtaining, const CancellationToken& token) = 0;
 
   private:
     QString m_url;
@@ -96,8 +167,17 @@ class Feed : public RootItem, public QRunnable {
     AutoUpdateType m_autoUpdateType;
     int m_autoUpdateInitialInterval;
     int m_autoUpdateRemainingInterval;
+    int m_adaptiveUpdateInterval;
+    int m_consecutiveFailures;
+    qint64 m_nextUpdateAttempt;
     int m_totalCount;
     int m_unreadCount;
+    FetchResult m_fetchResult;
+    bool m_hasFetchResult;
+    CancellationToken* m_cancellationToken;
+    bool m_contentsUnchanged;
+    bool m_fetchStateSaved;
+    MessageBatch m_obtainedMessages;
 };
 
 Q_DECLARE_METATYPE(Feed::AutoUpdateType)
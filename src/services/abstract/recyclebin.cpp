@@ -39,7 +39,7 @@ void RecycleBin::updateCounts(bool update_total_count) {
   bool is_main_thread = QThread::currentThread() == qApp->thread();
   QSqlDatabase database = is_main_thread ?
                           qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings) :
-                          qApp->database()->connection(QSL("feed_upd"), DatabaseFactory::FromSettings);
+                          qApp->database()->connection(QSL(APP_DB_WRITER_CONNECTION), DatabaseFactory::FromSettings);
 
   m_unreadCount = DatabaseQueries::getMessageCountsForBin(database, getParentServiceRoot()->accountId(), false);
 
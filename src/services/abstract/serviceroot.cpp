@@ -451,20 +451,15 @@ void ServiceRoot::setAccountId(int account_id) {
 
 bool ServiceRoot::loadMessagesForItem(RootItem* item, MessagesModel* model) {
   if (item->kind() == RootItemKind::Bin) {
-    model->setFilter(QString("Messages.is_deleted = 1 AND Messages.is_pdeleted = 0 AND Messages.account_id = %1")
-                     .arg(QString::number(accountId())));
+    model->setFilter(DatabaseQueries::messagesFilterForBin(accountId()));
   }
   else {
     QList<Feed*> children = item->getSubTreeFeeds();
-    QString filter_clause = textualFeedIds(children).join(QSL(", "));
+    QStringList feed_ids = textualFeedIds(children);
     QString urls = textualFeedUrls(children).join(QSL(", "));
 
-    model->setFilter(
-      QString("Feeds.custom_id IN (%1) AND Messages.is_deleted = 0 AND Messages.is_pdeleted = 0 AND Messages.account_id = %2").arg(
-        filter_clause,
-        QString::
-        number(accountId())));
-    qDebug("Displaying messages from feeds IDs: %s and URLs: %s.", qPrintable(filter_clause), qPrintable(urls));
+    model->setFilter(DatabaseQueries::messagesFilterForFeeds(feed_ids, accountId()));
+    qDebug("Displaying messages from feeds IDs: %s and URLs: %s.", qPrintable(feed_ids.join(QSL(", "))), qPrintable(urls));
   }
 
   return true;
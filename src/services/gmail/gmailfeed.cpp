@@ -3,6 +3,7 @@
 #include "services/gmail/gmailfeed.h"
 
 #include "miscellaneous/application.h"
+#include "miscellaneous/cancellationtoken.h"
 #include "miscellaneous/iconfactory.h"
 #include "services/gmail/gmailserviceroot.h"
 #include "services/gmail/network/gmailnetworkfactory.h"
@@ -21,10 +22,14 @@ GmailServiceRoot* GmailFeed::serviceRoot() const {
   return qobject_cast<GmailServiceRoot*>(getParentServiceRoot());
 }
 
-QList<Message> GmailFeed::obtainNewMessages(bool* error_during_obtaining) {
+QList<Message> GmailFeed::obtainNewMessages(bool* error_during_obtaining, const CancellationToken& token) {
   Feed::Status error = Feed::Status::Normal;
   QList<Message> messages = serviceRoot()->network()->messages(customId(), error);
 
+  if (token.isCancelled()) {
+    return QList<Message>();
+  }
+
   setStatus(error);
 
   if (error == Feed::Status::NetworkError || error == Feed::Status::AuthError || error == Feed::Status::ParsingError) {
@@ -16,7 +16,7 @@ class GmailFeed : public Feed {
     GmailServiceRoot* serviceRoot() const;
 
   private:
-    QList<Message> obtainNewMessages(bool* error_during_obtaining);
+    QList<Message> obtainNewMessages(bool* error_during_obtaining, const CancellationToken& token);
 };
 
 #endif // GMAILFEED_H
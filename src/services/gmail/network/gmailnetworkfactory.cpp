@@ -124,9 +124,7 @@ QList<Message> GmailNetworkFactory::messages(const QString& stream_id, Feed::Sta
 
     if (downloader.lastOutputError() == QNetworkReply::NetworkError::NoError) {
       // We parse this chunk.
-      QString messages_data = downloader.lastOutputData();
-
-      QList<Message> more_messages = decodeLiteMessages(messages_data, stream_id, next_page_token);
+      QList<Message> more_messages = decodeLiteMessages(downloader.lastOutputData(), stream_id, next_page_token);
       QList<Message> full_messages;
 
       // Now, we via batch HTTP request obtain full data for each message.
@@ -428,17 +426,17 @@ bool GmailNetworkFactory::obtainAndDecodeFullMessages(const QList<Message>& lite
   }
 }
 
-QList<Message> GmailNetworkFactory::decodeLiteMessages(const QString& messages_json_data, const QString& stream_id,
+QList<Message> GmailNetworkFactory::decodeLiteMessages(const QByteArray& messages_json_data, const QString& stream_id,
                                                        QString& next_page_token) {
   QList<Message> messages;
-  QJsonObject top_object = QJsonDocument::fromJson(messages_json_data.toUtf8()).object();
+  const QJsonObject top_object = QJsonDocument::fromJson(messages_json_data).object();
   QJsonArray json_msgs = top_object["messages"].toArray();
 
   next_page_token = top_object["nextPageToken"].toString();
   messages.reserve(json_msgs.count());
 
   foreach (const QJsonValue& obj, json_msgs) {
-    auto message_obj = obj.toObject();
+    const QJsonObject message_obj = obj.toObject();
     Message message;
 
     message.m_customId = message_obj["id"].toString();
@@ -52,7 +52,7 @@ class GmailNetworkFactory : public QObject {
   private:
     bool fillFullMessage(Message& msg, const QJsonObject& json, const QString& feed_id);
     bool obtainAndDecodeFullMessages(const QList<Message>& lite_messages, const QString& feed_id, QList<Message>& full_messages);
-    QList<Message> decodeLiteMessages(const QString& messages_json_data, const QString& stream_id, QString& next_page_token);
+    QList<Message> decodeLiteMessages(const QByteArray& messages_json_data, const QString& stream_id, QString& next_page_token);
 
     //RootItem* decodeFeedCategoriesData(const QString& categories);
 
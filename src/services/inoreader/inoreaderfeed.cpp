@@ -3,6 +3,7 @@
 #include "services/inoreader/inoreaderfeed.h"
 
 #include "miscellaneous/application.h"
+#include "miscellaneous/cancellationtoken.h"
 #include "miscellaneous/iconfactory.h"
 #include "services/inoreader/inoreaderserviceroot.h"
 #include "services/inoreader/network/inoreadernetworkfactory.h"
@@ -15,10 +16,14 @@ InoreaderServiceRoot* InoreaderFeed::serviceRoot() const {
   return qobject_cast<InoreaderServiceRoot*>(getParentServiceRoot());
 }
 
-QList<Message> InoreaderFeed::obtainNewMessages(bool* error_during_obtaining) {
+QList<Message> InoreaderFeed::obtainNewMessages(bool* error_during_obtaining, const CancellationToken& token) {
   Feed::Status error = Feed::Status::Normal;
   QList<Message> messages = serviceRoot()->network()->messages(customId(), error);
 
+  if (token.isCancelled()) {
+    return QList<Message>();
+  }
+
   setStatus(error);
 
   if (error == Feed::Status::NetworkError || error == Feed::Status::AuthError) {
@@ -15,7 +15,7 @@ class InoreaderFeed : public Feed {
     InoreaderServiceRoot* serviceRoot() const;
 
   private:
-    QList<Message> obtainNewMessages(bool* error_during_obtaining);
+    QList<Message> obtainNewMessages(bool* error_during_obtaining, const CancellationToken& token);
 };
 
 #endif // INOREADERFEED_H
@@ -92,7 +92,7 @@ RootItem* InoreaderNetworkFactory::feedsCategories(bool obtain_icons) {
     return nullptr;
   }
 
-  QString category_data = downloader.lastOutputData();
+  QByteArray category_data = downloader.lastOutputData();
 
   downloader.manipulateData(INOREADER_API_LIST_FEEDS, QNetworkAccessManager::Operation::GetOperation);
   loop.exec();
@@ -101,7 +101,7 @@ RootItem* InoreaderNetworkFactory::feedsCategories(bool obtain_icons) {
     return nullptr;
   }
 
-  QString feed_data = downloader.lastOutputData();
+  QByteArray feed_data = downloader.lastOutputData();
 
   return decodeFeedCategoriesData(category_data, feed_data, obtain_icons);
 }
@@ -132,10 +132,8 @@ QList<Message> InoreaderNetworkFactory::messages(const QString& stream_id, Feed:
     return QList<Message>();
   }
   else {
-    QString messages_data = downloader.lastOutputData();
-
     error = Feed::Status::Normal;
-    return decodeMessages(messages_data, stream_id);
+    return decodeMessages(downloader.lastOutputData(), stream_id);
   }
 }
 
@@ -297,14 +295,14 @@ void InoreaderNetworkFactory::onAuthFailed() {
   });
 }
 
-QList<Message> InoreaderNetworkFactory::decodeMessages(const QString& messages_json_data, const QString& stream_id) {
+QList<Message> InoreaderNetworkFactory::decodeMessages(const QByteArray& messages_json_data, const QString& stream_id) {
   QList<Message> messages;
-  QJsonArray json = QJsonDocument::fromJson(messages_json_data.toUtf8()).object()["items"].toArray();
+  QJsonArray json = QJsonDocument::fromJson(messages_json_data).object()["items"].toArray();
 
   messages.reserve(json.count());
 
   foreach (const QJsonValue& obj, json) {
-    auto message_obj = obj.toObject();
+    const QJsonObject message_obj = obj.toObject();
     Message message;
 
     message.m_title = message_obj["title"].toString();
@@ -318,7 +316,7 @@ QList<Message> InoreaderNetworkFactory::decodeMessages(const QString& messages_j
     auto categories = message_obj["categories"].toArray();
 
     foreach (const QJsonValue& alt, alternates) {
-      auto alt_obj = alt.toObject();
+      const QJsonObject alt_obj = alt.toObject();
       QString mime = alt_obj["type"].toString();
       QString href = alt_obj["href"].toString();
 
@@ -331,7 +329,7 @@ QList<Message> InoreaderNetworkFactory::decodeMessages(const QString& messages_j
     }
 
     foreach (const QJsonValue& enc, enclosures) {
-      auto enc_obj = enc.toObject();
+      const QJsonObject enc_obj = enc.toObject();
       QString mime = enc_obj["type"].toString();
       QString href = enc_obj["href"].toString();
 
@@ -358,9 +356,9 @@ QList<Message> InoreaderNetworkFactory::decodeMessages(const QString& messages_j
   return messages;
 }
 
-RootItem* InoreaderNetworkFactory::decodeFeedCategoriesData(const QString& categories, const QString& feeds, bool obtain_icons) {
+RootItem* InoreaderNetworkFactory::decodeFeedCategoriesData(const QByteArray& categories, const QByteArray& feeds, bool obtain_icons) {
   RootItem* parent = new RootItem();
-  QJsonArray json = QJsonDocument::fromJson(categories.toUtf8()).object()["tags"].toArray();
+  QJsonArray json = QJsonDocument::fromJson(categories).object()["tags"].toArray();
 
   QMap<QString, RootItem*> cats;
   cats.insert(QString(), parent);
@@ -384,7 +382,7 @@ RootItem* InoreaderNetworkFactory::decodeFeedCategoriesData(const QString& categ
     }
   }
 
-  json = QJsonDocument::fromJson(feeds.toUtf8()).object()["subscriptions"].toArray();
+  json = QJsonDocument::fromJson(feeds).object()["subscriptions"].toArray();
 
   foreach (const QJsonValue& obj, json) {
     auto subscription = obj.toObject();
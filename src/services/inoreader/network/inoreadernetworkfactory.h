@@ -47,8 +47,8 @@ class InoreaderNetworkFactory : public QObject {
     void onAuthFailed();
 
   private:
-    QList<Message> decodeMessages(const QString& messages_json_data, const QString& stream_id);
-    RootItem* decodeFeedCategoriesData(const QString& categories, const QString& feeds, bool obtain_icons);
+    QList<Message> decodeMessages(const QByteArray& messages_json_data, const QString& stream_id);
+    RootItem* decodeFeedCategoriesData(const QByteArray& categories, const QByteArray& feeds, bool obtain_icons);
 
     void initializeOauth();
 
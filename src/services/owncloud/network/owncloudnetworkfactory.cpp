@@ -94,7 +94,7 @@ OwnCloudUserResponse OwnCloudNetworkFactory::userInfo() {
                                                                         QByteArray(), result_raw,
                                                                         QNetworkAccessManager::GetOperation,
                                                                         headers);
-  OwnCloudUserResponse user_response(QString::fromUtf8(result_raw));
+  OwnCloudUserResponse user_response(result_raw);
 
   if (network_reply.first != QNetworkReply::NoError) {
     qWarning("ownCloud: Obtaining user info failed with error %d.", network_reply.first);
@@ -117,7 +117,7 @@ OwnCloudStatusResponse OwnCloudNetworkFactory::status() {
                                                                         QByteArray(), result_raw,
                                                                         QNetworkAccessManager::GetOperation,
                                                                         headers);
-  OwnCloudStatusResponse status_response(QString::fromUtf8(result_raw));
+  OwnCloudStatusResponse status_response(result_raw);
 
   if (network_reply.first != QNetworkReply::NoError) {
     qWarning("ownCloud: Obtaining status info failed with error %d.", network_reply.first);
@@ -147,7 +147,7 @@ OwnCloudGetFeedsCategoriesResponse OwnCloudNetworkFactory::feedsCategories() {
     return OwnCloudGetFeedsCategoriesResponse();
   }
 
-  QString content_categories = QString::fromUtf8(result_raw);
+  QByteArray content_categories = result_raw;
 
   // Now, obtain feeds.
   network_reply = NetworkFactory::performNetworkOperation(m_urlFeeds,
@@ -163,7 +163,7 @@ OwnCloudGetFeedsCategoriesResponse OwnCloudNetworkFactory::feedsCategories() {
     return OwnCloudGetFeedsCategoriesResponse();
   }
 
-  QString content_feeds = QString::fromUtf8(result_raw);
+  QByteArray content_feeds = result_raw;
 
   m_lastError = network_reply.first;
   return OwnCloudGetFeedsCategoriesResponse(content_categories, content_feeds);
@@ -275,7 +275,7 @@ OwnCloudGetMessagesResponse OwnCloudNetworkFactory::getMessages(int feed_id) {
                                                                         QByteArray(), result_raw,
                                                                         QNetworkAccessManager::GetOperation,
                                                                         headers);
-  OwnCloudGetMessagesResponse msgs_response(QString::fromUtf8(result_raw));
+  OwnCloudGetMessagesResponse msgs_response(result_raw);
 
   if (network_reply.first != QNetworkReply::NoError) {
     qWarning("ownCloud: Obtaining messages failed with error %d.", network_reply.first);
@@ -429,8 +429,8 @@ void OwnCloudNetworkFactory::setUserId(const QString& userId) {
   m_userId = userId;
 }
 
-OwnCloudResponse::OwnCloudResponse(const QString& raw_content) {
-  m_rawContent = QJsonDocument::fromJson(raw_content.toUtf8()).object();
+OwnCloudResponse::OwnCloudResponse(const QByteArray& raw_content) {
+  m_rawContent = QJsonDocument::fromJson(raw_content).object();
   m_emptyString = raw_content.isEmpty();
 }
 
@@ -444,7 +444,7 @@ QString OwnCloudResponse::toString() const {
   return QJsonDocument(m_rawContent).toJson(QJsonDocument::Compact);
 }
 
-OwnCloudUserResponse::OwnCloudUserResponse(const QString& raw_content) : OwnCloudResponse(raw_content) {}
+OwnCloudUserResponse::OwnCloudUserResponse(const QByteArray& raw_content) : OwnCloudResponse(raw_content) {}
 
 OwnCloudUserResponse::~OwnCloudUserResponse() {}
 
@@ -489,7 +489,7 @@ QIcon OwnCloudUserResponse::avatar() const {
   return QIcon();
 }
 
-OwnCloudStatusResponse::OwnCloudStatusResponse(const QString& raw_content) : OwnCloudResponse(raw_content) {}
+OwnCloudStatusResponse::OwnCloudStatusResponse(const QByteArray& raw_content) : OwnCloudResponse(raw_content) {}
 
 OwnCloudStatusResponse::~OwnCloudStatusResponse() {}
 
@@ -511,8 +511,8 @@ bool OwnCloudStatusResponse::misconfiguredCron() const {
   }
 }
 
-OwnCloudGetFeedsCategoriesResponse::OwnCloudGetFeedsCategoriesResponse(const QString& raw_categories,
-                                                                       const QString& raw_feeds)
+OwnCloudGetFeedsCategoriesResponse::OwnCloudGetFeedsCategoriesResponse(const QByteArray& raw_categories,
+                                                                       const QByteArray& raw_feeds)
   : m_contentCategories(raw_categories), m_contentFeeds(raw_feeds) {}
 
 OwnCloudGetFeedsCategoriesResponse::~OwnCloudGetFeedsCategoriesResponse() {}
@@ -526,8 +526,8 @@ RootItem* OwnCloudGetFeedsCategoriesResponse::feedsCategories(bool obtain_icons)
   cats.insert(QSL("0"), parent);
 
   // Process categories first, then process feeds.
-  foreach (const QJsonValue& cat, QJsonDocument::fromJson(m_contentCategories.toUtf8()).object()["folders"].toArray()) {
-    QJsonObject item = cat.toObject();
+  foreach (const QJsonValue& cat, QJsonDocument::fromJson(m_contentCategories).object()["folders"].toArray()) {
+    const QJsonObject item = cat.toObject();
     Category* category = new Category();
 
     category->setTitle(item["name"].toString());
@@ -539,8 +539,8 @@ RootItem* OwnCloudGetFeedsCategoriesResponse::feedsCategories(bool obtain_icons)
   }
 
   // We have categories added, now add all feeds.
-  foreach (const QJsonValue& fed, QJsonDocument::fromJson(m_contentFeeds.toUtf8()).object()["feeds"].toArray()) {
-    QJsonObject item = fed.toObject();
+  foreach (const QJsonValue& fed, QJsonDocument::fromJson(m_contentFeeds).object()["feeds"].toArray()) {
+    const QJsonObject item = fed.toObject();
     OwnCloudFeed* feed = new OwnCloudFeed();
 
     if (obtain_icons) {
@@ -572,7 +572,7 @@ RootItem* OwnCloudGetFeedsCategoriesResponse::feedsCategories(bool obtain_icons)
   return parent;
 }
 
-OwnCloudGetMessagesResponse::OwnCloudGetMessagesResponse(const QString& raw_content) : OwnCloudResponse(raw_content) {}
+OwnCloudGetMessagesResponse::OwnCloudGetMessagesResponse(const QByteArray& raw_content) : OwnCloudResponse(raw_content) {}
 
 OwnCloudGetMessagesResponse::~OwnCloudGetMessagesResponse() {}
 
@@ -580,7 +580,7 @@ QList<Message>OwnCloudGetMessagesResponse::messages() const {
   QList<Message>msgs;
 
   foreach (const QJsonValue& message, m_rawContent["items"].toArray()) {
-    QJsonObject message_map = message.toObject();
+    const QJsonObject message_map = message.toObject();
     Message msg;
 
     msg.m_author = message_map["author"].toString();
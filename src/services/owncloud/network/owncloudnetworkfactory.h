@@ -14,7 +14,7 @@
 
 class OwnCloudResponse {
   public:
-    explicit OwnCloudResponse(const QString& raw_content = QString());
+    explicit OwnCloudResponse(const QByteArray& raw_content = QByteArray());
     virtual ~OwnCloudResponse();
 
     bool isLoaded() const;
@@ -27,7 +27,7 @@ class OwnCloudResponse {
 
 class OwnCloudUserResponse : public OwnCloudResponse {
   public:
-    explicit OwnCloudUserResponse(const QString& raw_content = QString());
+    explicit OwnCloudUserResponse(const QByteArray& raw_content = QByteArray());
     virtual ~OwnCloudUserResponse();
 
     QString userId() const;
@@ -38,7 +38,7 @@ class OwnCloudUserResponse : public OwnCloudResponse {
 
 class OwnCloudGetMessagesResponse : public OwnCloudResponse {
   public:
-    explicit OwnCloudGetMessagesResponse(const QString& raw_content = QString());
+    explicit OwnCloudGetMessagesResponse(const QByteArray& raw_content = QByteArray());
     virtual ~OwnCloudGetMessagesResponse();
 
     QList<Message> messages() const;
@@ -46,7 +46,7 @@ class OwnCloudGetMessagesResponse : public OwnCloudResponse {
 
 class OwnCloudStatusResponse : public OwnCloudResponse {
   public:
-    explicit OwnCloudStatusResponse(const QString& raw_content = QString());
+    explicit OwnCloudStatusResponse(const QByteArray& raw_content = QByteArray());
     virtual ~OwnCloudStatusResponse();
 
     QString version() const;
@@ -57,7 +57,8 @@ class RootItem;
 
 class OwnCloudGetFeedsCategoriesResponse {
   public:
-    explicit OwnCloudGetFeedsCategoriesResponse(const QString& raw_categories = QString(), const QString& raw_feeds = QString());
+    explicit OwnCloudGetFeedsCategoriesResponse(const QByteArray& raw_categories = QByteArray(),
+                                                const QByteArray& raw_feeds = QByteArray());
     virtual ~OwnCloudGetFeedsCategoriesResponse();
 
     // Returns tree of feeds/categories.
@@ -66,8 +67,8 @@ class OwnCloudGetFeedsCategoriesResponse {
     RootItem* feedsCategories(bool obtain_icons) const;
 
   private:
-    QString m_contentCategories;
-    QString m_contentFeeds;
+    QByteArray m_contentCategories;
+    QByteArray m_contentFeeds;
 };
 
 class OwnCloudNetworkFactory {
@@ -2,6 +2,7 @@
 
 #include "services/owncloud/owncloudfeed.h"
 
+#include "miscellaneous/cancellationtoken.h"
 #include "miscellaneous/databasequeries.h"
 #include "miscellaneous/iconfactory.h"
 #include "services/owncloud/gui/formowncloudfeeddetails.h"
@@ -66,10 +67,14 @@ OwnCloudServiceRoot* OwnCloudFeed::serviceRoot() const {
   return qobject_cast<OwnCloudServiceRoot*>(getParentServiceRoot());
 }
 
-QList<Message> OwnCloudFeed::obtainNewMessages(bool* error_during_obtaining) {
+QList<Message> OwnCloudFeed::obtainNewMessages(bool* error_during_obtaining, const CancellationToken& token) {
   OwnCloudGetMessagesResponse messages = serviceRoot()->network()->getMessages(customNumericId());
 
-  if (serviceRoot()->network()->lastError() != QNetworkReply::NoError) {
+  if (token.isCancelled()) {
+    *error_during_obtaining = false;
+    return QList<Message>();
+  }
+  else if (serviceRoot()->network()->lastError() != QNetworkReply::NoError) {
     setStatus(Feed::NetworkError);
     *error_during_obtaining = true;
     serviceRoot()->itemChanged(QList<RootItem*>() << this);
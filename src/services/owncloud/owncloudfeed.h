@@ -26,7 +26,7 @@ class OwnCloudFeed : public Feed {
     OwnCloudServiceRoot* serviceRoot() const;
 
   private:
-    QList<Message> obtainNewMessages(bool* error_during_obtaining);
+    QList<Message> obtainNewMessages(bool* error_during_obtaining, const CancellationToken& token);
 };
 
 #endif // OWNCLOUDFEED_H
@@ -8,65 +8,140 @@
 
 #include "exceptions/applicationexception.h"
 
-AtomParser::AtomParser(const QString& data) : FeedParser(data) {
-  QString version = m_xml.documentElement().attribute(QSL("version"));
+AtomParser::AtomParser(const QByteArray& data, const QByteArray& fallback_encoding)
+  : FeedParser(data, fallback_encoding), m_atomNamespace(QString()), m_authors(QStringList()) {}
 
-  if (version == QSL("0.3")) {
-    m_atomNamespace = QSL("http://purl.org/atom/ns#");
+AtomParser::~AtomParser() {}
+
+bool AtomParser::isMessageElement() const {
+  return !m_atomNamespace.isEmpty() && isElement(QSL("entry"), m_atomNamespace);
+}
+
+void AtomParser::processFeedElement() {
+  if (m_atomNamespace.isEmpty()) {
+    // This is root element, it tells us the version of Atom.
+    if (m_xml.attributes().value(QSL("version")) == QSL("0.3")) {
+      m_atomNamespace = QSL("http://purl.org/atom/ns#");
+    }
+    else {
+      m_atomNamespace = QSL("http://www.w3.org/2005/Atom");
+    }
   }
-  else {
-    m_atomNamespace = QSL("http://www.w3.org/2005/Atom");
+  else if (isElement(QSL("author"), m_atomNamespace)) {
+    readAuthorName();
   }
 }
 
-AtomParser::~AtomParser() {}
-
 QString AtomParser::feedAuthor() const {
-  QDomNodeList authors = m_xml.documentElement().elementsByTagNameNS(m_atomNamespace, QSL("author"));
-  QStringList author_str;
-
-  for (int i = 0; i < authors.size(); i++) {
-    QDomNodeList names = authors.at(i).toElement().elementsByTagNameNS(m_atomNamespace, QSL("name"));
+  return m_authors.join(", ");
+}
 
-    if (!names.isEmpty()) {
-      const QString name = names.at(0).toElement().text();
+QString AtomParser::readAuthorName() {
+  QString name;
+  bool has_name = false;
 
-      if (!name.isEmpty() && !author_str.contains(name)) {
-        author_str.append(name);
-      }
+  while (m_xml.readNextStartElement()) {
+    if (!has_name && isElement(QSL("name"), m_atomNamespace)) {
+      has_name = true;
+      name = readText();
+    }
+    else {
+      m_xml.skipCurrentElement();
     }
   }
 
-  return author_str.join(", ");
+  // All authors from the document are used for messages
+  // without their own author.
+  if (!name.isEmpty() && !m_authors.contains(name)) {
+    m_authors.append(name);
+  }
+
+  return name;
 }
 
-Message AtomParser::extractMessage(const QDomElement& msg_element, QDateTime current_time) const {
+Message AtomParser::extractMessage(const QDateTime& current_time) {
   Message new_message;
-  QString title = textsFromPath(msg_element, m_atomNamespace, QSL("title"), true).join(QSL(", "));
-  QString summary = textsFromPath(msg_element, m_atomNamespace, QSL("content"), true).join(QSL(", "));
+  QString title, content, summary, updated, modified;
+  QString last_link_alternate, last_link_other;
+  QStringList authors;
+  bool has_title = false, has_content = false, has_summary = false, has_updated = false, has_modified = false;
 
-  if (summary.isEmpty()) {
-    summary = textsFromPath(msg_element, m_atomNamespace, QSL("summary"), true).join(QSL(", "));
+  // Only first occurrence of each text element is used.
+  while (m_xml.readNextStartElement()) {
+    if (m_xml.namespaceUri() != m_atomNamespace) {
+      m_xml.skipCurrentElement();
+    }
+    else if (!has_title && isElement(QSL("title"))) {
+      has_title = true;
+      title = readText();
+    }
+    else if (!has_content && isElement(QSL("content"))) {
+      has_content = true;
+      content = readText();
+    }
+    else if (!has_summary && isElement(QSL("summary"))) {
+      has_summary = true;
+      summary = readText();
+    }
+    else if (!has_updated && isElement(QSL("updated"))) {
+      has_updated = true;
+      updated = readText();
+    }
+    else if (!has_modified && isElement(QSL("modified"))) {
+      has_modified = true;
+      modified = readText();
+    }
+    else if (isElement(QSL("author"))) {
+      const QString name = readAuthorName();
+
+      if (!name.isEmpty()) {
+        authors.append(name);
+      }
+    }
+    else if (isElement(QSL("link"))) {
+      const QXmlStreamAttributes attributes = m_xml.attributes();
+      const QString rel = attributes.value(QSL("rel")).toString();
+
+      if (rel == QSL("enclosure")) {
+        new_message.m_enclosures.append(Enclosure(attributes.value(QSL("href")).toString(),
+                                                  attributes.value(QSL("type")).toString()));
+        qDebug("Found enclosure '%s' for the message.", qPrintable(new_message.m_enclosures.last().m_url));
+      }
+      else if (rel.isEmpty() || rel == QSL("alternate")) {
+        last_link_alternate = attributes.value(QSL("href")).toString();
+      }
+      else {
+        last_link_other = attributes.value(QSL("href")).toString();
+      }
+
+      m_xml.skipCurrentElement();
+    }
+    else {
+      m_xml.skipCurrentElement();
+    }
+  }
+
+  if (content.isEmpty()) {
+    content = summary;
   }
 
   // Now we obtained maximum of information for title & description.
-  if (title.isEmpty() && summary.isEmpty()) {
+  if (title.isEmpty() && content.isEmpty()) {
     // BOTH title and description are empty, skip this message.
     throw ApplicationException(QSL("Not enough data for the message."));
   }
 
   // Title is not empty, description does not matter.
   new_message.m_title = qApp->web()->stripTags(title);
-  new_message.m_contents = summary;
-  new_message.m_author = qApp->web()->escapeHtml(messageAuthor(msg_element));
-  QString updated = textsFromPath(msg_element, m_atomNamespace, QSL("updated"), true).join(QSL(", "));
+  new_message.m_contents = content;
+  new_message.m_author = qApp->web()->escapeHtml(authors.join(", "));
 
   if (updated.isEmpty()) {
-    updated = textsFromPath(msg_element, m_atomNamespace, QSL("modified"), true).join(QSL(", "));
+    updated = modified;
   }
 
   // Deal with creation date.
-  new_message.m_created = TextFactory::parseDateTime(updated);
+  new_message.m_created = parseDateTime(updated);
   new_message.m_createdFromFeed = !new_message.m_created.isNull();
 
   if (!new_message.m_createdFromFeed) {
@@ -75,25 +150,6 @@ Message AtomParser::extractMessage(const QDomElement& msg_element, QDateTime cur
   }
 
   // Deal with links
-  QDomNodeList elem_links = msg_element.toElement().elementsByTagNameNS(m_atomNamespace, QSL("link"));
-  QString last_link_alternate, last_link_other;
-
-  for (int i = 0; i < elem_links.size(); i++) {
-    QDomElement link = elem_links.at(i).toElement();
-    QString attribute = link.attribute(QSL("rel"));
-
-    if (attribute == QSL("enclosure")) {
-      new_message.m_enclosures.append(Enclosure(link.attribute(QSL("href")), link.attribute(QSL("type"))));
-      qDebug("Found enclosure '%s' for the message.", qPrintable(new_message.m_enclosures.last().m_url));
-    }
-    else if (attribute.isEmpty() || attribute == QSL("alternate")) {
-      last_link_alternate = link.attribute(QSL("href"));
-    }
-    else {
-      last_link_other = link.attribute(QSL("href"));
-    }
-  }
-
   if (!last_link_alternate.isEmpty()) {
     new_message.m_url = last_link_alternate;
   }
@@ -106,22 +162,3 @@ Message AtomParser::extractMessage(const QDomElement& msg_element, QDateTime cur
 
   return new_message;
 }
-
-QString AtomParser::messageAuthor(const QDomElement& msg_element) const {
-  QDomNodeList authors = msg_element.elementsByTagNameNS(m_atomNamespace, QSL("author"));
-  QStringList author_str;
-
-  for (int i = 0; i < authors.size(); i++) {
-    QDomNodeList names = authors.at(i).toElement().elementsByTagNameNS(m_atomNamespace, QSL("name"));
-
-    if (!names.isEmpty()) {
-      author_str.append(names.at(0).toElement().text());
-    }
-  }
-
-  return author_str.join(", ");
-}
-
-QDomNodeList AtomParser::messageElements() {
-  return m_xml.elementsByTagNameNS(m_atomNamespace, QSL("entry"));
-}
@@ -7,22 +7,26 @@
 
 #include "core/message.h"
 
-#include <QDomDocument>
 #include <QList>
+#include <QStringList>
 
 class AtomParser : public FeedParser {
   public:
-    explicit AtomParser(const QString& data);
+    explicit AtomParser(const QByteArray& data, const QByteArray& fallback_encoding = QByteArray());
     virtual ~AtomParser();
 
   private:
-    QDomNodeList messageElements();
+    bool isMessageElement() const;
+    void processFeedElement();
     QString feedAuthor() const;
-    Message extractMessage(const QDomElement& msg_element, QDateTime current_time) const;
-    QString messageAuthor(const QDomElement& msg_element) const;
+    Message extractMessage(const QDateTime& current_time);
+
+    // Reads current "author" element and returns its name.
+    QString readAuthorName();
 
   private:
     QString m_atomNamespace;
+    QStringList m_authors;
 };
 
 #endif // ATOMPARSER_H
@@ -3,87 +3,182 @@
 #include "services/standard/feedparser.h"
 
 #include "exceptions/applicationexception.h"
+#include "miscellaneous/cancellationtoken.h"
 
 #include <QDebug>
-#include <QRegularExpression>
+#include <QTextCodec>
 
-FeedParser::FeedParser(const QString& data) : m_xmlData(data) {
-  m_xml.setContent(m_xmlData, true);
+FeedParser::FeedParser(const QByteArray& data, const QByteArray& fallback_encoding)
+  : m_dateTimeFormat(TextFactory::UnknownDateTimeFormat) {
+  m_xml.addData(prepareData(data, fallback_encoding));
 }
 
 FeedParser::~FeedParser() {}
 
-QList<Message> FeedParser::messages() {
-  QString feed_author = feedAuthor();
-
+QList<Message> FeedParser::messages(const CancellationToken* token) {
   QList<Message> messages;
   QDateTime current_time = QDateTime::currentDateTime();
 
-  // Pull out all messages.
-  QDomNodeList messages_in_xml = messageElements();
-
-  for (int i = 0; i < messages_in_xml.size(); i++) {
-    QDomNode message_item = messages_in_xml.item(i);
-
-    try {
-      Message new_message = extractMessage(message_item.toElement(), current_time);
+  while (!m_xml.atEnd()) {
+    if (token != nullptr && token->isCancelled()) {
+      qDebug("Parsing of feed was cancelled after %d messages.", messages.size());
+      break;
+    }
 
-      if (new_message.m_author.isEmpty()) {
-        new_message.m_author = feed_author;
-      }
+    if (m_xml.readNext() != QXmlStreamReader::StartElement) {
+      continue;
+    }
 
-      new_message.m_url = new_message.m_url.replace(QRegularExpression("[\\t\\n]"), QString());
+    if (!isMessageElement()) {
+      processFeedElement();
+      continue;
+    }
 
-      messages.append(new_message);
+    try {
+      messages.append(extractMessage(current_time));
     }
     catch (const ApplicationException& ex) {
       qDebug() << ex.message();
     }
   }
 
+  if (m_xml.hasError()) {
+    qWarning("Feed XML is not well-formed, error '%s' on line %lld, %d messages were parsed.",
+             qPrintable(m_xml.errorString()), m_xml.lineNumber(), messages.size());
+  }
+
+  // Feed-level author might be placed after some messages,
+  // so it is assigned once whole document is read.
+  const QString feed_author = feedAuthor();
+
+  if (!feed_author.isEmpty()) {
+    for (int i = 0; i < messages.size(); i++) {
+      if (messages.at(i).m_author.isEmpty()) {
+        messages[i].m_author = feed_author;
+      }
+    }
+  }
+
   return messages;
 }
 
-QStringList FeedParser::textsFromPath(const QDomElement& element, const QString& namespace_uri,
-                                      const QString& xml_path, bool only_first) const {
-  QStringList paths = xml_path.split('/');
-  QStringList result;
+TextFactory::DateTimeFormat FeedParser::dateTimeFormat() const {
+  return m_dateTimeFormat;
+}
 
-  QList<QDomElement> current_elements;
-  current_elements.append(element);
+void FeedParser::setDateTimeFormat(const TextFactory::DateTimeFormat& format) {
+  m_dateTimeFormat = format;
+}
+
+void FeedParser::processFeedElement() {}
+
+QString FeedParser::feedAuthor() const {
+  return "";
+}
 
-  while (!paths.isEmpty()) {
-    QList<QDomElement> next_elements;
-    QString next_local_name = paths.takeFirst();
+QString FeedParser::readText() {
+  return m_xml.readElementText(QXmlStreamReader::IncludeChildElements);
+}
 
-    foreach (const QDomElement& elem, current_elements) {
-      QDomNodeList elements = elem.elementsByTagNameNS(namespace_uri, next_local_name);
+QByteArray FeedParser::prepareData(const QByteArray& data, const QByteArray& fallback_encoding) {
+  if (hasByteOrderMark(data)) {
+    // Reader detects encoding on its own.
+    return data;
+  }
 
-      for (int i = 0; i < elements.size(); i++) {
-        next_elements.append(elements.at(i).toElement());
+  const QByteArray declared_encoding = declaredEncoding(data);
 
-        if (only_first) {
-          break;
-        }
-      }
+  if (!declared_encoding.isEmpty() && QTextCodec::codecForName(declared_encoding) != nullptr) {
+    return data;
+  }
 
-      if (next_elements.size() == 1 && only_first) {
-        break;
-      }
+  QTextCodec* codec = fallback_encoding.isEmpty() ? nullptr : QTextCodec::codecForName(fallback_encoding);
+
+  if (codec == nullptr) {
+    if (declared_encoding.isEmpty()) {
+      // XML defaults to UTF-8.
+      return data;
+    }
+    else {
+      qWarning("Feed declares unknown encoding '%s', using UTF-8.", declared_encoding.constData());
+      codec = QTextCodec::codecForMib(106);
     }
+  }
+
+  if (declared_encoding.isEmpty() && codec->mibEnum() == 106) {
+    return data;
+  }
+
+  return withDeclaredEncoding(data, codec->name());
+}
+
+bool FeedParser::hasByteOrderMark(const QByteArray& data) {
+  return data.startsWith("\xEF\xBB\xBF") || data.startsWith("\xFE\xFF") || data.startsWith("\xFF\xFE") ||
+         data.startsWith(QByteArray("\x00\x00\xFE\xFF", 4));
+}
+
+QByteArray FeedParser::declaredEncoding(const QByteArray& data) {
+  if (!data.startsWith("<?xml")) {
+    return QByteArray();
+  }
+
+  const int prolog_end = data.indexOf("?>");
+  const int encoding_index = data.indexOf("encoding", 5);
+
+  if (prolog_end < 0 || encoding_index < 0 || encoding_index > prolog_end) {
+    return QByteArray();
+  }
 
-    current_elements = next_elements;
+  const int value_start = data.indexOf('=', encoding_index) + 1;
+
+  if (value_start <= 0 || value_start >= prolog_end) {
+    return QByteArray();
+  }
+
+  QByteArray value = data.mid(value_start, prolog_end - value_start).trimmed();
+
+  if (value.isEmpty() || (value.at(0) != '"' && value.at(0) != '\'')) {
+    return QByteArray();
   }
 
-  if (!current_elements.isEmpty()) {
-    foreach (const QDomElement& elem, current_elements) {
-      result.append(elem.text());
+  const int value_end = value.indexOf(value.at(0), 1);
+
+  return value_end < 0 ? QByteArray() : value.mid(1, value_end - 1).trimmed();
+}
+
+QByteArray FeedParser::withDeclaredEncoding(const QByteArray& data, const QByteArray& encoding) {
+  QByteArray result;
+  int prolog_end = data.startsWith("<?xml") ? data.indexOf("?>") : -1;
+
+  result.reserve(data.size() + encoding.size() + 64);
+
+  if (prolog_end < 0) {
+    result.append("<?xml version=\"1.0\" encoding=\"").append(encoding).append("\"?>");
+    prolog_end = 0;
+  }
+  else {
+    // Encoding must be declared between version and standalone declarations,
+    // declaration of unknown encoding is dropped.
+    const QByteArray prolog = data.left(prolog_end);
+    const int encoding_index = prolog.indexOf("encoding");
+    const int standalone_index = prolog.indexOf("standalone");
+    const int head_end = encoding_index >= 0 ? encoding_index : (standalone_index >= 0 ? standalone_index : prolog.size());
+
+    result.append(prolog.left(head_end).trimmed()).append(" encoding=\"").append(encoding).append('"');
+
+    if (standalone_index >= 0) {
+      result.append(' ').append(prolog.mid(standalone_index).trimmed());
     }
   }
 
+  result.append(data.constData() + prolog_end, data.size() - prolog_end);
   return result;
 }
 
-QString FeedParser::feedAuthor() const {
-  return "";
+QDateTime FeedParser::parseDateTime(const QString& date_time) {
+  return TextFactory::parseDateTime(date_time, &m_dateTimeFormat);
+}
+
+bool FeedParser::isElement(const QString& local_name, const QString& namespace_uri) const {
+  return m_xml.name() == local_name && (namespace_uri.isNull() || m_xml.namespaceUri() == namespace_uri);
 }
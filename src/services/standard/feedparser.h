@@ -3,27 +3,76 @@
 #ifndef FEEDPARSER_H
 #define FEEDPARSER_H
 
-#include <QDomDocument>
+#include <QByteArray>
 #include <QString>
+#include <QXmlStreamReader>
 
 #include "core/message.h"
+#include "miscellaneous/textfactory.h"
 
+class CancellationToken;
+
+// Base class for streaming feed parsers. Document is read
+// in a single pass and each message is built as soon as its
+// element ends, so memory usage is proportional to one message
+// and not to the whole document.
+//
+// Raw data are handed to the reader which decodes them chunk by chunk.
+// Encoding is taken from byte order mark or XML prolog. If none of them
+// is present, "fallback_encoding" (usually from "Content-Type" header or
+// stored with the feed) is used.
 class FeedParser {
   public:
-    explicit FeedParser(const QString& data);
+    explicit FeedParser(const QByteArray& data, const QByteArray& fallback_encoding = QByteArray());
     virtual ~FeedParser();
 
-    virtual QList<Message> messages();
+    // Parsing stops (and messages parsed so far are returned)
+    // once "token" is cancelled.
+    virtual QList<Message> messages(const CancellationToken* token = nullptr);
+
+    // Format of dates used by the feed. Set it to format detected
+    // during previous parsing so that dates are parsed faster.
+    TextFactory::DateTimeFormat dateTimeFormat() const;
+    void setDateTimeFormat(const TextFactory::DateTimeFormat& format);
 
   protected:
-    QStringList textsFromPath(const QDomElement& element, const QString& namespace_uri, const QString& xml_path, bool only_first) const;
-    virtual QDomNodeList messageElements() = 0;
+
+    // Returns true if current start element begins a message.
+    virtual bool isMessageElement() const = 0;
+
+    // Reads current message element up to its end element
+    // and returns the message.
+    virtual Message extractMessage(const QDateTime& current_time) = 0;
+
+    // Processes start element which is not part of any message,
+    // for example root element or feed-level metadata.
+    virtual void processFeedElement();
     virtual QString feedAuthor() const;
-    virtual Message extractMessage(const QDomElement& msg_element, QDateTime current_time) const = 0;
+
+    // Returns text of current element including texts of all its
+    // children, reader ends on the end element.
+    QString readText();
+
+    // Parses date of message, remembers format of the date.
+    QDateTime parseDateTime(const QString& date_time);
+
+    // Returns true if current start element has given local name
+    // and (if specified) given namespace.
+    bool isElement(const QString& local_name, const QString& namespace_uri = QString()) const;
+
+  private:
+    static QByteArray prepareData(const QByteArray& data, const QByteArray& fallback_encoding);
+    static bool hasByteOrderMark(const QByteArray& data);
+
+    // Returns value of "encoding" pseudo-attribute of XML prolog.
+    static QByteArray declaredEncoding(const QByteArray& data);
+
+    // Returns data with XML prolog which declares given encoding.
+    static QByteArray withDeclaredEncoding(const QByteArray& data, const QByteArray& encoding);
 
   protected:
-    QString m_xmlData;
-    QDomDocument m_xml;
+    QXmlStreamReader m_xml;
+    TextFactory::DateTimeFormat m_dateTimeFormat;
 };
 
 #endif // FEEDPARSER_H
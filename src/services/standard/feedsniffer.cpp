@@ -0,0 +1,220 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#include "services/standard/feedsniffer.h"
+
+#include "definitions/definitions.h"
+
+#include <QTextCodec>
+
+FeedSniffer::FeedSniffer()
+  : m_xml(), m_bytesRead(0), m_depth(0), m_channelDepth(0), m_fieldDepth(0), m_field(nullptr), m_finished(false),
+  m_isFeed(false), m_type(StandardFeed::Rss2X), m_encoding(QString()), m_title(QString()), m_description(QString()),
+  m_sourceLink(QString()) {}
+
+bool FeedSniffer::addData(const QByteArray& chunk) {
+  if (m_finished) {
+    return true;
+  }
+
+  m_xml.addData(chunk);
+  m_bytesRead += chunk.size();
+
+  while (!m_finished) {
+    switch (m_xml.readNext()) {
+      case QXmlStreamReader::StartDocument:
+        m_encoding = m_xml.documentEncoding().toString();
+        break;
+
+      case QXmlStreamReader::StartElement:
+        m_depth++;
+        processStartElement();
+        break;
+
+      case QXmlStreamReader::EndElement:
+        processEndElement();
+        m_depth--;
+        break;
+
+      case QXmlStreamReader::Characters:
+        if (m_field != nullptr) {
+          m_field->append(m_xml.text());
+        }
+
+        break;
+
+      case QXmlStreamReader::EndDocument:
+        m_finished = true;
+        break;
+
+      case QXmlStreamReader::Invalid:
+        if (m_xml.error() != QXmlStreamReader::PrematureEndOfDocumentError) {
+          m_finished = true;
+        }
+
+        // Either the document is broken or we need more data.
+        return m_finished || m_bytesRead >= FEED_SNIFFER_MAX_SIZE;
+
+      default:
+        break;
+    }
+  }
+
+  return true;
+}
+
+void FeedSniffer::finish() {
+  m_finished = true;
+}
+
+bool FeedSniffer::isFinished() const {
+  return m_finished;
+}
+
+bool FeedSniffer::isFeed() const {
+  return m_isFeed;
+}
+
+bool FeedSniffer::hasError() const {
+  // Premature end is expected because we usually do not read whole document.
+  return !m_isFeed || (m_xml.hasError() && m_xml.error() != QXmlStreamReader::PrematureEndOfDocumentError);
+}
+
+QString FeedSniffer::errorString() const {
+  if (m_xml.hasError() && m_xml.error() != QXmlStreamReader::PrematureEndOfDocumentError) {
+    return QString(QSL("%1 (line %2, column %3)")).arg(m_xml.errorString(),
+                                                       QString::number(m_xml.lineNumber()),
+                                                       QString::number(m_xml.columnNumber()));
+  }
+  else if (!m_isFeed) {
+    return QSL("root element of known feed format was not found");
+  }
+  else {
+    return QString();
+  }
+}
+
+StandardFeed::Type FeedSniffer::type() const {
+  return m_type;
+}
+
+QString FeedSniffer::encoding() const {
+  // Document without declaration is UTF-8, also use it if we do not know the declared codec.
+  if (m_encoding.isEmpty() || QTextCodec::codecForName(m_encoding.toLocal8Bit()) == nullptr) {
+    return QSL(DEFAULT_FEED_ENCODING);
+  }
+  else {
+    return m_encoding;
+  }
+}
+
+QString FeedSniffer::title() const {
+  return m_title.simplified();
+}
+
+QString FeedSniffer::description() const {
+  return m_description.simplified();
+}
+
+QString FeedSniffer::sourceLink() const {
+  return m_sourceLink.trimmed();
+}
+
+void FeedSniffer::processStartElement() {
+  const QStringRef name = m_xml.name();
+
+  if (m_depth == 1) {
+    if (name == QL1S("RDF")) {
+      // We found RDF feed.
+      m_type = StandardFeed::Rdf;
+      m_isFeed = true;
+    }
+    else if (name == QL1S("rss")) {
+      // We found RSS 0.91/0.92/0.93/2.0/2.0.1 feed.
+      const QStringRef rss_type = m_xml.attributes().value(QL1S("version"));
+
+      m_type = rss_type == QL1S("0.91") || rss_type == QL1S("0.92") || rss_type == QL1S("0.93")
+               ? StandardFeed::Rss0X
+               : StandardFeed::Rss2X;
+      m_isFeed = true;
+    }
+    else if (name == QL1S("feed")) {
+      // We found ATOM feed, its metadata are direct children of root element.
+      m_type = StandardFeed::Atom10;
+      m_channelDepth = 1;
+      m_isFeed = true;
+    }
+    else {
+      // File really is XML file but feed format was NOT recognized.
+      m_finished = true;
+    }
+
+    return;
+  }
+
+  if (m_channelDepth == 0) {
+    if (m_depth == 2 && name == QL1S("channel")) {
+      m_channelDepth = m_depth;
+    }
+
+    return;
+  }
+
+  if (m_depth != m_channelDepth + 1 || m_field != nullptr) {
+    return;
+  }
+
+  if (m_type == StandardFeed::Atom10) {
+    if (name == QL1S("entry")) {
+      // No more feed-level metadata are to be expected.
+      m_finished = true;
+    }
+    else if (name == QL1S("title") && m_title.isEmpty()) {
+      m_field = &m_title;
+    }
+    else if (name == QL1S("subtitle") && m_description.isEmpty()) {
+      m_field = &m_description;
+    }
+    else if (name == QL1S("link") && m_sourceLink.isEmpty()) {
+      const QXmlStreamAttributes attributes = m_xml.attributes();
+      const QStringRef rel = attributes.value(QL1S("rel"));
+
+      if (rel.isEmpty() || rel == QL1S("alternate")) {
+        m_sourceLink = attributes.value(QL1S("href")).toString();
+        m_finished = hasAllMetadata();
+      }
+    }
+  }
+  else if (name == QL1S("item")) {
+    m_finished = true;
+  }
+  else if (m_xml.prefix().isEmpty()) {
+    // Elements from other namespaces, for example "atom:link", are ignored.
+    if (name == QL1S("title") && m_title.isEmpty()) {
+      m_field = &m_title;
+    }
+    else if (name == QL1S("description") && m_description.isEmpty()) {
+      m_field = &m_description;
+    }
+    else if (name == QL1S("link") && m_sourceLink.isEmpty()) {
+      m_field = &m_sourceLink;
+    }
+  }
+
+  if (m_field != nullptr) {
+    m_fieldDepth = m_depth;
+  }
+}
+
+void FeedSniffer::processEndElement() {
+  if (m_field != nullptr && m_depth == m_fieldDepth) {
+    m_field = nullptr;
+    m_finished = hasAllMetadata();
+  }
+  else if (m_depth == m_channelDepth) {
+    m_finished = true;
+  }
+}
+
+bool FeedSniffer::hasAllMetadata() const {
+  return !m_title.trimmed().isEmpty() && !m_description.trimmed().isEmpty() && !m_sourceLink.trimmed().isEmpty();
+}
@@ -0,0 +1,62 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#ifndef FEEDSNIFFER_H
+#define FEEDSNIFFER_H
+
+#include "services/standard/standardfeed.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QXmlStreamReader>
+
+// Detects type and metadata of feed from the beginning of its document.
+// Data are added chunk by chunk as they arrive from network and sniffing
+// finishes as soon as root element, title, description and home page link
+// are known, so the rest of the document does not have to be downloaded.
+class FeedSniffer {
+  public:
+    explicit FeedSniffer();
+
+    // Adds next chunk of raw data. Returns true once
+    // sniffing is finished and no more data are needed.
+    bool addData(const QByteArray& chunk);
+
+    // Tells sniffer that there are no more data.
+    void finish();
+
+    bool isFinished() const;
+
+    // Returns true if root element of some known feed format was found.
+    bool isFeed() const;
+
+    // Returns true if document is not valid XML or it is not a feed.
+    bool hasError() const;
+    QString errorString() const;
+
+    StandardFeed::Type type() const;
+    QString encoding() const;
+    QString title() const;
+    QString description() const;
+    QString sourceLink() const;
+
+  private:
+    void processStartElement();
+    void processEndElement();
+    bool hasAllMetadata() const;
+
+    QXmlStreamReader m_xml;
+    int m_bytesRead;
+    int m_depth;
+    int m_channelDepth;
+    int m_fieldDepth;
+    QString* m_field;
+    bool m_finished;
+    bool m_isFeed;
+    StandardFeed::Type m_type;
+    QString m_encoding;
+    QString m_title;
+    QString m_description;
+    QString m_sourceLink;
+};
+
+#endif // FEEDSNIFFER_H
@@ -2,82 +2,90 @@
 
 #include "services/standard/rdfparser.h"
 
+#include "exceptions/applicationexception.h"
 #include "miscellaneous/application.h"
 #include "miscellaneous/textfactory.h"
 #include "network-web/webfactory.h"
 
-#include <QDomDocument>
-
-RdfParser::RdfParser() {}
+RdfParser::RdfParser(const QByteArray& data, const QByteArray& fallback_encoding)
+  : FeedParser(data, fallback_encoding) {}
 
 RdfParser::~RdfParser() {}
 
-QList<Message> RdfParser::parseXmlData(const QString& data) {
-  QList<Message> messages;
-  QDomDocument xml_file;
-  QDateTime current_time = QDateTime::currentDateTime();
-
-  xml_file.setContent(data, true);
-
-  // Pull out all messages.
-  QDomNodeList messages_in_xml = xml_file.elementsByTagName(QSL("item"));
-
-  for (int i = 0; i < messages_in_xml.size(); i++) {
-    QDomNode message_item = messages_in_xml.item(i);
-    Message new_message;
+bool RdfParser::isMessageElement() const {
+  return isElement(QSL("item"));
+}
 
-    // Deal with title and description.
-    QString elem_title = message_item.namedItem(QSL("title")).toElement().text().simplified();
-    QString elem_description = message_item.namedItem(QSL("description")).toElement().text();
+Message RdfParser::extractMessage(const QDateTime& current_time) {
+  Message new_message;
+  QString elem_title, elem_description, elem_link, elem_creator, elem_updated;
+  bool has_title = false, has_description = false, has_link = false, has_creator = false, has_updated = false;
 
-    // Now we obtained maximum of information for title & description.
-    if (elem_title.isEmpty()) {
-      if (elem_description.isEmpty()) {
-        // BOTH title and description are empty, skip this message.
-        continue;
-      }
-      else {
-        // Title is empty but description is not.
-        new_message.m_title = qApp->web()->escapeHtml(qApp->web()->stripTags(elem_description.simplified()));
-        new_message.m_contents = elem_description;
-      }
+  // Only first occurrence of each child element is used.
+  while (m_xml.readNextStartElement()) {
+    if (!has_title && isElement(QSL("title"))) {
+      has_title = true;
+      elem_title = readText().simplified();
+    }
+    else if (!has_description && isElement(QSL("description"))) {
+      has_description = true;
+      elem_description = readText();
+    }
+    else if (!has_link && isElement(QSL("link"))) {
+      has_link = true;
+      elem_link = readText();
+    }
+    else if (!has_creator && isElement(QSL("creator"))) {
+      has_creator = true;
+      elem_creator = readText();
+    }
+    else if (!has_updated && isElement(QSL("date"))) {
+      has_updated = true;
+      elem_updated = readText();
     }
     else {
-      // Title is really not empty, description does not matter.
-      new_message.m_title = qApp->web()->escapeHtml(qApp->web()->stripTags(elem_title));
-      new_message.m_contents = elem_description;
+      m_xml.skipCurrentElement();
     }
+  }
 
-    // Deal with link and author.
-    new_message.m_url = message_item.namedItem(QSL("link")).toElement().text();
-    new_message.m_author = message_item.namedItem(QSL("creator")).toElement().text();
-
-    // Deal with creation date.
-    QString elem_updated = message_item.namedItem(QSL("date")).toElement().text();
-
-    if (elem_updated.isEmpty()) {
-      elem_updated = message_item.namedItem(QSL("dc:date")).toElement().text();
+  // Now we obtained maximum of information for title & description.
+  if (elem_title.isEmpty()) {
+    if (elem_description.isEmpty()) {
+      // BOTH title and description are empty, skip this message.
+      throw ApplicationException(QSL("Not enough data for the message."));
+    }
+    else {
+      // Title is empty but description is not.
+      new_message.m_title = qApp->web()->escapeHtml(qApp->web()->stripTags(elem_description.simplified()));
+      new_message.m_contents = elem_description;
     }
+  }
+  else {
+    // Title is really not empty, description does not matter.
+    new_message.m_title = qApp->web()->escapeHtml(qApp->web()->stripTags(elem_title));
+    new_message.m_contents = elem_description;
+  }
 
-    // Deal with creation date.
-    new_message.m_created = TextFactory::parseDateTime(elem_updated);
-    new_message.m_createdFromFeed = !new_message.m_created.isNull();
+  // Deal with link and author.
+  new_message.m_url = elem_link;
+  new_message.m_author = elem_creator;
 
-    if (!new_message.m_createdFromFeed) {
-      // Date was NOT obtained from the feed, set current date as creation date for the message.
-      new_message.m_created = current_time;
-    }
+  // Deal with creation date.
+  new_message.m_created = parseDateTime(elem_updated);
+  new_message.m_createdFromFeed = !new_message.m_created.isNull();
 
-    if (new_message.m_author.isNull()) {
-      new_message.m_author = "";
-    }
+  if (!new_message.m_createdFromFeed) {
+    // Date was NOT obtained from the feed, set current date as creation date for the message.
+    new_message.m_created = current_time;
+  }
 
-    if (new_message.m_url.isNull()) {
-      new_message.m_url = "";
-    }
+  if (new_message.m_author.isNull()) {
+    new_message.m_author = "";
+  }
 
-    messages.append(new_message);
+  if (new_message.m_url.isNull()) {
+    new_message.m_url = "";
   }
 
-  return messages;
+  return new_message;
 }
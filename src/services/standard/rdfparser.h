@@ -3,16 +3,20 @@
 #ifndef RDFPARSER_H
 #define RDFPARSER_H
 
+#include "services/standard/feedparser.h"
+
 #include "core/message.h"
 
 #include <QList>
 
-class RdfParser {
+class RdfParser : public FeedParser {
   public:
-    explicit RdfParser();
+    explicit RdfParser(const QByteArray& data, const QByteArray& fallback_encoding = QByteArray());
     virtual ~RdfParser();
 
-    QList<Message> parseXmlData(const QString& data);
+  private:
+    bool isMessageElement() const;
+    Message extractMessage(const QDateTime& current_time);
 };
 
 #endif // RDFPARSER_H
@@ -8,34 +8,71 @@
 #include "miscellaneous/textfactory.h"
 #include "network-web/webfactory.h"
 
-#include <QDomDocument>
-
-RssParser::RssParser(const QString& data) : FeedParser(data) {}
+RssParser::RssParser(const QByteArray& data, const QByteArray& fallback_encoding)
+  : FeedParser(data, fallback_encoding) {}
 
 RssParser::~RssParser() {}
 
-QDomNodeList RssParser::messageElements() {
-  QDomNode channel_elem = m_xml.namedItem(QSL("rss")).namedItem(QSL("channel"));
-
-  if (channel_elem.isNull()) {
-    return QDomNodeList();
-  }
-  else {
-    return channel_elem.toElement().elementsByTagName(QSL("item"));
-  }
+bool RssParser::isMessageElement() const {
+  return isElement(QSL("item"));
 }
 
-Message RssParser::extractMessage(const QDomElement& msg_element, QDateTime current_time) const {
+Message RssParser::extractMessage(const QDateTime& current_time) {
   Message new_message;
+  QString elem_title, elem_encoded, elem_description, elem_enclosure, elem_enclosure_type;
+  QString elem_link, elem_link_href, elem_author, elem_creator, elem_pub_date, elem_date;
+  bool has_title = false, has_encoded = false, has_description = false, has_enclosure = false;
+  bool has_link = false, has_author = false, has_creator = false, has_pub_date = false, has_date = false;
+
+  // Only first occurrence of each child element is used.
+  while (m_xml.readNextStartElement()) {
+    if (!has_title && isElement(QSL("title"))) {
+      has_title = true;
+      elem_title = readText().simplified();
+    }
+    else if (!has_encoded && isElement(QSL("encoded"))) {
+      has_encoded = true;
+      elem_encoded = readText();
+    }
+    else if (!has_description && isElement(QSL("description"))) {
+      has_description = true;
+      elem_description = readText();
+    }
+    else if (!has_enclosure && isElement(QSL("enclosure"))) {
+      has_enclosure = true;
+      elem_enclosure = m_xml.attributes().value(QSL("url")).toString();
+      elem_enclosure_type = m_xml.attributes().value(QSL("type")).toString();
+      m_xml.skipCurrentElement();
+    }
+    else if (!has_link && isElement(QSL("link"))) {
+      has_link = true;
+      elem_link_href = m_xml.attributes().value(QSL("href")).toString();
+      elem_link = readText();
+    }
+    else if (!has_author && isElement(QSL("author"))) {
+      has_author = true;
+      elem_author = readText();
+    }
+    else if (!has_creator && isElement(QSL("creator"))) {
+      has_creator = true;
+      elem_creator = readText();
+    }
+    else if (!has_pub_date && isElement(QSL("pubDate"))) {
+      has_pub_date = true;
+      elem_pub_date = readText();
+    }
+    else if (!has_date && isElement(QSL("date"))) {
+      has_date = true;
+      elem_date = readText();
+    }
+    else {
+      m_xml.skipCurrentElement();
+    }
+  }
 
   // Deal with titles & descriptions.
-  QString elem_title = msg_element.namedItem(QSL("title")).toElement().text().simplified();
-  QString elem_description = msg_element.namedItem(QSL("encoded")).toElement().text();
-  QString elem_enclosure = msg_element.namedItem(QSL("enclosure")).toElement().attribute(QSL("url"));
-  QString elem_enclosure_type = msg_element.namedItem(QSL("enclosure")).toElement().attribute(QSL("type"));
-
-  if (elem_description.isEmpty()) {
-    elem_description = msg_element.namedItem(QSL("description")).toElement().text();
+  if (!elem_encoded.isEmpty()) {
+    elem_description = elem_encoded;
   }
 
   // Now we obtained maximum of information for title & description.
@@ -62,7 +99,7 @@ Message RssParser::extractMessage(const QDomElement& msg_element, QDateTime curr
   }
 
   // Deal with link and author.
-  new_message.m_url = msg_element.namedItem(QSL("link")).toElement().text();
+  new_message.m_url = elem_link;
 
   if (new_message.m_url.isEmpty() && !new_message.m_enclosures.isEmpty()) {
     new_message.m_url = new_message.m_enclosures.first().m_url;
@@ -70,20 +107,20 @@ Message RssParser::extractMessage(const QDomElement& msg_element, QDateTime curr
 
   if (new_message.m_url.isEmpty()) {
     // Try to get "href" attribute.
-    new_message.m_url = msg_element.namedItem(QSL("link")).toElement().attribute(QSL("href"));
+    new_message.m_url = elem_link_href;
   }
 
-  new_message.m_author = msg_element.namedItem(QSL("author")).toElement().text();
+  new_message.m_author = elem_author;
 
   if (new_message.m_author.isEmpty()) {
-    new_message.m_author = msg_element.namedItem(QSL("creator")).toElement().text();
+    new_message.m_author = elem_creator;
   }
 
   // Deal with creation date.
-  new_message.m_created = TextFactory::parseDateTime(msg_element.namedItem(QSL("pubDate")).toElement().text());
+  new_message.m_created = parseDateTime(elem_pub_date);
 
   if (new_message.m_created.isNull()) {
-    new_message.m_created = TextFactory::parseDateTime(msg_element.namedItem(QSL("date")).toElement().text());
+    new_message.m_created = parseDateTime(elem_date);
   }
 
   if (!(new_message.m_createdFromFeed = !new_message.m_created.isNull())) {
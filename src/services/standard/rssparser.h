@@ -11,12 +11,12 @@
 
 class RssParser : public FeedParser {
   public:
-    explicit RssParser(const QString& data);
+    explicit RssParser(const QByteArray& data, const QByteArray& fallback_encoding = QByteArray());
     virtual ~RssParser();
 
   private:
-    QDomNodeList messageElements();
-    Message extractMessage(const QDomElement& msg_element, QDateTime current_time) const;
+    bool isMessageElement() const;
+    Message extractMessage(const QDateTime& current_time);
 };
 
 #endif // RSSPARSER_H
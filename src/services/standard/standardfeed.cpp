@@ -6,26 +6,26 @@
 #include "definitions/definitions.h"
 #include "gui/feedmessageviewer.h"
 #include "gui/feedsview.h"
+#include "miscellaneous/cancellationtoken.h"
 #include "miscellaneous/databasequeries.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/settings.h"
 #include "miscellaneous/simplecrypt/simplecrypt.h"
 #include "miscellaneous/textfactory.h"
+#include "network-web/downloader.h"
 #include "network-web/networkfactory.h"
 #include "services/abstract/recyclebin.h"
 #include "services/standard/atomparser.h"
+#include "services/standard/feedsniffer.h"
 #include "services/standard/gui/formstandardfeeddetails.h"
 #include "services/standard/rdfparser.h"
 #include "services/standard/rssparser.h"
 #include "services/standard/standardserviceroot.h"
 
-#include <QDomDocument>
-#include <QDomElement>
-#include <QDomNode>
+#include <QEventLoop>
 #include <QPointer>
-#include <QTextCodec>
+#include <QScopedPointer>
 #include <QVariant>
-#include <QXmlStreamReader>
 
 StandardFeed::StandardFeed(RootItem* parent_item)
   : Feed(parent_item) {
@@ -35,6 +35,10 @@ StandardFeed::StandardFeed(RootItem* parent_item)
   m_networkError = QNetworkReply::NoError;
   m_type = Rss0X;
   m_encoding = QString();
+  m_httpETag = m_httpLastModified = QString();
+  m_pendingHttpETag = m_pendingHttpLastModified = QString();
+  m_contentHash = m_pendingContentHash = 0;
+  m_dateTimeFormat = TextFactory::UnknownDateTimeFormat;
 }
 
 StandardFeed::StandardFeed(const StandardFeed& other)
@@ -45,6 +49,10 @@ StandardFeed::StandardFeed(const StandardFeed& other)
   m_networkError = other.networkError();
   m_type = other.type();
   m_encoding = other.encoding();
+  m_httpETag = m_pendingHttpETag = other.httpETag();
+  m_httpLastModified = m_pendingHttpLastModified = other.httpLastModified();
+  m_contentHash = m_pendingContentHash = other.contentHash();
+  m_dateTimeFormat = TextFactory::UnknownDateTimeFormat;
 }
 
 StandardFeed::~StandardFeed() {
@@ -56,7 +64,7 @@ QList<QAction*> StandardFeed::contextMenu() {
 }
 
 QString StandardFeed::additionalTooltip() const {
-  return Feed::additionalTooltip() + tr("Network status: %1\n"
+  return Feed::additionalTooltip() + QL1S("\n") + tr("Network status: %1\n"
                                         "Encoding: %2\n"
                                         "Type: %3").arg(NetworkFactory::networkErrorText(m_networkError),
                                                         encoding(),
@@ -139,132 +147,65 @@ QPair<StandardFeed*, QNetworkReply::NetworkError> StandardFeed::guessFeed(const
                                                                           const QString& password) {
   QPair<StandardFeed*, QNetworkReply::NetworkError> result;
   result.first = nullptr;
-  QByteArray feed_contents;
-
-  QList<QPair<QByteArray, QByteArray>> headers;
-  headers << NetworkFactory::generateBasicAuthHeader(username, password);
-
-  NetworkResult network_result = NetworkFactory::performNetworkOperation(url,
-                                                                         qApp->settings()->value(GROUP(Feeds),
-                                                                                                 SETTING(Feeds::UpdateTimeout)).toInt(),
-                                                                         QByteArray(),
-                                                                         feed_contents,
-                                                                         QNetworkAccessManager::GetOperation,
-                                                                         headers);
-
-  result.second = network_result.first;
-
-  if (result.second == QNetworkReply::NoError || !feed_contents.isEmpty()) {
-    // Feed XML was obtained, now we need to try to guess
-    // its encoding before we can read further data.
-    QString xml_schema_encoding;
-    QString xml_contents_encoded;
-    QRegExp encoding_rexp(QSL("encoding=\"[^\"]\\S+\""));
-
-    if (encoding_rexp.indexIn(feed_contents) != -1 &&
-        !(xml_schema_encoding = encoding_rexp.cap(0)).isEmpty()) {
-      // Some "encoding" attribute was found get the encoding
-      // out of it.
-      encoding_rexp.setPattern(QSL("[^\"]\\S+[^\"]"));
-      encoding_rexp.indexIn(xml_schema_encoding, 9);
-      xml_schema_encoding = encoding_rexp.cap(0);
-    }
 
-    if (result.first == nullptr) {
-      result.first = new StandardFeed();
-    }
+  // We only need metadata from the beginning of the document, so data are
+  // sniffed as they arrive and the download is stopped once we have them.
+  FeedSniffer sniffer;
+  Downloader downloader;
+  QEventLoop loop;
+  int received_bytes = 0;
 
-    QTextCodec* custom_codec = QTextCodec::codecForName(xml_schema_encoding.toLocal8Bit());
+  QObject::connect(&downloader, &Downloader::dataReceived, [&](const QByteArray& chunk) {
+    received_bytes += chunk.size();
 
-    if (custom_codec != nullptr) {
-      // Feed encoding was probably guessed.
-      xml_contents_encoded = custom_codec->toUnicode(feed_contents);
-      result.first->setEncoding(xml_schema_encoding);
-    }
-    else {
-      // Feed encoding probably not guessed, set it as
-      // default.
-      xml_contents_encoded = feed_contents;
-      result.first->setEncoding(DEFAULT_FEED_ENCODING);
+    if (sniffer.addData(chunk)) {
+      downloader.finishEarly();
     }
+  });
+  QObject::connect(&downloader, &Downloader::completed, &loop, &QEventLoop::quit);
+
+  const QPair<QByteArray, QByteArray> auth_header = NetworkFactory::generateBasicAuthHeader(username, password);
+
+  if (!auth_header.first.isEmpty()) {
+    downloader.appendRawHeader(auth_header.first, auth_header.second);
+  }
+
+  downloader.setStreamContents(true);
+  downloader.manipulateData(url, QNetworkAccessManager::GetOperation, QByteArray(),
+                            qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt());
+  loop.exec();
+
+  sniffer.finish();
+  result.second = downloader.lastOutputError();
+
+  if (result.second == QNetworkReply::NoError || received_bytes > 0) {
+    qDebug("Sniffed %d bytes of feed '%s'.", received_bytes, qPrintable(url));
 
-    // Feed XML was obtained, guess it now.
-    QDomDocument xml_document;
-    QString error_msg;
-    int error_line, error_column;
-
-    if (!xml_document.setContent(xml_contents_encoded,
-                                 &error_msg,
-                                 &error_line,
-                                 &error_column)) {
-      qDebug("XML of feed '%s' is not valid and cannot be loaded. Error: '%s' "
-             "(line %d, column %d).",
+    if (!sniffer.isFeed()) {
+      qDebug("Feed '%s' is not valid or its format is not known. Error: '%s'.",
              qPrintable(url),
-             qPrintable(error_msg),
-             error_line, error_column);
+             qPrintable(sniffer.errorString()));
       result.second = QNetworkReply::UnknownContentError;
 
-      // XML is invalid, exit.
+      // XML is invalid or it is not a feed, exit.
       return result;
     }
 
-    QDomElement root_element = xml_document.documentElement();
-    QString root_tag_name = root_element.tagName();
+    result.first = new StandardFeed();
+    result.first->setType(sniffer.type());
+    result.first->setEncoding(sniffer.encoding());
+    result.first->setTitle(sniffer.title());
+    result.first->setDescription(sniffer.description());
 
     QList<QString> icon_possible_locations;
-    icon_possible_locations.append(url);
-
-    if (root_tag_name == QL1S("rdf:RDF")) {
-      // We found RDF feed.
-      QDomElement channel_element = root_element.namedItem(QSL("channel")).toElement();
+    const QString source_link = sniffer.sourceLink();
 
-      result.first->setType(Rdf);
-      result.first->setTitle(channel_element.namedItem(QSL("title")).toElement().text());
-      result.first->setDescription(channel_element.namedItem(QSL("description")).toElement().text());
-      QString source_link = channel_element.namedItem(QSL("link")).toElement().text();
-
-      if (!source_link.isEmpty()) {
-        icon_possible_locations.prepend(source_link);
-      }
-    }
-    else if (root_tag_name == QL1S("rss")) {
-      // We found RSS 0.91/0.92/0.93/2.0/2.0.1 feed.
-      QString rss_type = root_element.attribute("version", "2.0");
-
-      if (rss_type == QL1S("0.91") || rss_type == QL1S("0.92") || rss_type == QL1S("0.93")) {
-        result.first->setType(Rss0X);
-      }
-      else {
-        result.first->setType(Rss2X);
-      }
-
-      QDomElement channel_element = root_element.namedItem(QSL("channel")).toElement();
-
-      result.first->setTitle(channel_element.namedItem(QSL("title")).toElement().text());
-      result.first->setDescription(channel_element.namedItem(QSL("description")).toElement().text());
-      QString source_link = channel_element.namedItem(QSL("link")).toElement().text();
-
-      if (!source_link.isEmpty()) {
-        icon_possible_locations.prepend(source_link);
-      }
-    }
-    else if (root_tag_name == QL1S("feed")) {
-      // We found ATOM feed.
-      result.first->setType(Atom10);
-      result.first->setTitle(root_element.namedItem(QSL("title")).toElement().text());
-      result.first->setDescription(root_element.namedItem(QSL("subtitle")).toElement().text());
-      QString source_link = root_element.namedItem(QSL("link")).toElement().text();
-
-      if (!source_link.isEmpty()) {
-        icon_possible_locations.prepend(source_link);
-      }
-    }
-    else {
-      // File was downloaded and it really was XML file
-      // but feed format was NOT recognized.
-      result.second = QNetworkReply::UnknownContentError;
+    if (!source_link.isEmpty()) {
+      icon_possible_locations.append(source_link);
     }
 
+    icon_possible_locations.append(url);
+
     // Try to obtain icon.
     QIcon icon_data;
 
@@ -354,6 +295,10 @@ bool StandardFeed::editItself(StandardFeed* new_feed_data) {
   original_feed->setAutoUpdateInitialInterval(new_feed_data->autoUpdateInitialInterval());
   original_feed->setType(new_feed_data->type());
 
+  // Validators were cleared by the edit, next update downloads and processes full contents.
+  original_feed->setHttpValidators(QString(), QString());
+  original_feed->setContentHash(0);
+
   // Editing is done.
   return true;
 }
@@ -398,19 +343,85 @@ void StandardFeed::setEncoding(const QString& encoding) {
   m_encoding = encoding;
 }
 
-QList<Message> StandardFeed::obtainNewMessages(bool* error_during_obtaining) {
-  QByteArray feed_contents;
-  int download_timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
+bool StandardFeed::prepareFetch(FetchRequest& request) const {
+  request.m_url = url();
+  request.m_timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
+  request.m_headers << NetworkFactory::generateBasicAuthHeader(username(), password());
+
+  if (!m_httpETag.isEmpty()) {
+    request.m_headers << QPair<QByteArray, QByteArray>(HTTP_HEADERS_IF_NONE_MATCH, m_httpETag.toLatin1());
+  }
+
+  if (!m_httpLastModified.isEmpty()) {
+    request.m_headers << QPair<QByteArray, QByteArray>(HTTP_HEADERS_IF_MOD_SINCE, m_httpLastModified.toLatin1());
+  }
+
+  return true;
+}
+
+QString StandardFeed::httpETag() const {
+  return m_httpETag;
+}
+
+QString StandardFeed::httpLastModified() const {
+  return m_httpLastModified;
+}
 
-  QList<QPair<QByteArray, QByteArray>> headers;
-  headers << NetworkFactory::generateBasicAuthHeader(username(), password());
+void StandardFeed::setHttpValidators(const QString& etag, const QString& last_modified) {
+  m_httpETag = m_pendingHttpETag = etag;
+  m_httpLastModified = m_pendingHttpLastModified = last_modified;
+}
 
-  m_networkError = NetworkFactory::performNetworkOperation(url(),
-                                                           download_timeout,
-                                                           QByteArray(),
-                                                           feed_contents,
-                                                           QNetworkAccessManager::GetOperation,
-                                                           headers).first;
+quint64 StandardFeed::contentHash() const {
+  return m_contentHash;
+}
+
+void StandardFeed::setContentHash(quint64 content_hash) {
+  m_contentHash = m_pendingContentHash = content_hash;
+}
+
+bool StandardFeed::saveFetchState(QSqlDatabase& database) {
+  // NOTE: Pending values become current only once they are committed, see applyFetchState(),
+  // so if transaction with them is rolled back, they are stored again by next attempt.
+  if (m_pendingHttpETag == m_httpETag && m_pendingHttpLastModified == m_httpLastModified &&
+      m_pendingContentHash == m_contentHash) {
+    return true;
+  }
+
+  if (DatabaseQueries::storeFeedFetchState(database, id(), m_pendingHttpETag, m_pendingHttpLastModified, m_pendingContentHash)) {
+    return true;
+  }
+  else {
+    qWarning("Download state of feed '%s' (id %d) was not stored.", qPrintable(url()), id());
+    return false;
+  }
+}
+
+void StandardFeed::applyFetchState() {
+  m_httpETag = m_pendingHttpETag;
+  m_httpLastModified = m_pendingHttpLastModified;
+  m_contentHash = m_pendingContentHash;
+}
+
+QList<Message> StandardFeed::obtainNewMessages(bool* error_during_obtaining, const CancellationToken& token) {
+  FetchResult fetched;
+
+  if (!takeFetchResult(fetched)) {
+    // Data were not downloaded in advance, so fetch them now.
+    FetchRequest request;
+
+    prepareFetch(request);
+    fetched = FetchEngine::fetchBlocking(request);
+  }
+
+  const QByteArray& feed_contents = fetched.m_data;
+
+  if (token.isCancelled()) {
+    // Update was stopped, data are incomplete (if any).
+    return QList<Message>();
+  }
+
+  m_networkError = fetched.m_error;
 
   if (m_networkError != QNetworkReply::NoError) {
     qWarning("Error during fetching of new messages for feed '%s' (id %d).", qPrintable(url()), id());
@@ -422,40 +433,62 @@ QList<Message> StandardFeed::obtainNewMessages(bool* error_during_obtaining) {
     *error_during_obtaining = false;
   }
 
-  // Encode downloaded data for further parsing.
-  QTextCodec* codec = QTextCodec::codecForName(encoding().toLocal8Bit());
-  QString formatted_feed_contents;
+  if (fetched.m_httpCode == HTTP_CODE_NOT_MODIFIED) {
+    qDebug("Feed '%s' (id %d) was not modified since last update.", qPrintable(url()), id());
+    setContentsUnchanged(true);
+    return QList<Message>();
+  }
+
+  m_pendingHttpETag = QString::fromLatin1(fetched.header(HTTP_HEADERS_ETAG));
+  m_pendingHttpLastModified = QString::fromLatin1(fetched.header(HTTP_HEADERS_LAST_MODIFIED));
+  m_pendingContentHash = TextFactory::hash64(feed_contents);
 
-  if (codec == nullptr) {
-    // No suitable codec for this encoding was found.
-    // Use non-converted data.
-    formatted_feed_contents = feed_contents;
+  if (m_contentHash != 0 && m_pendingContentHash == m_contentHash) {
+    // Server does not support conditional requests but
+    // it sent exactly the same data as the last time.
+    qDebug("Contents of feed '%s' (id %d) did not change since last update.", qPrintable(url()), id());
+    setContentsUnchanged(true);
+    return QList<Message>();
   }
-  else {
-    formatted_feed_contents = codec->toUnicode(feed_contents);
+
+  // Raw data go directly to parsers, they are decoded as they are read. Encoding
+  // declared by the data has priority, then the one sent by the server and
+  // the stored one is used as the last resort.
+  QByteArray fallback_encoding = fetched.charset();
+
+  if (fallback_encoding.isEmpty()) {
+    fallback_encoding = encoding().toLatin1();
   }
 
-  // Feed data are downloaded and encoded.
   // Parse data and obtain messages.
+  QScopedPointer<FeedParser> parser;
   QList<Message> messages;
 
   switch (type()) {
     case StandardFeed::Rss0X:
     case StandardFeed::Rss2X:
-      messages = RssParser(formatted_feed_contents).messages();
+      parser.reset(new RssParser(feed_contents, fallback_encoding));
       break;
 
     case StandardFeed::Rdf:
-      messages = RdfParser().parseXmlData(formatted_feed_contents);
+      parser.reset(new RdfParser(feed_contents, fallback_encoding));
       break;
 
     case StandardFeed::Atom10:
-      messages = AtomParser(formatted_feed_contents).messages();
+      parser.reset(new AtomParser(feed_contents, fallback_encoding));
+      break;
 
     default:
       break;
   }
 
+  if (!parser.isNull()) {
+    // Dates in feed usually keep their format, so we remember it.
+    parser->setDateTimeFormat(m_dateTimeFormat);
+    messages = parser->messages(&token);
+    m_dateTimeFormat = parser->dateTimeFormat();
+  }
+
   return messages;
 }
 
@@ -477,5 +510,8 @@ StandardFeed::StandardFeed(const QSqlRecord& record) : Feed(record) {
 
   setAutoUpdateType(static_cast<Feed::AutoUpdateType>(record.value(FDS_DB_UPDATE_TYPE_INDEX).toInt()));
   setAutoUpdateInitialInterval(record.value(FDS_DB_UPDATE_INTERVAL_INDEX).toInt());
+  setHttpValidators(record.value(FDS_DB_HTTP_ETAG_INDEX).toString(), record.value(FDS_DB_HTTP_LASTMOD_INDEX).toString());
+  setContentHash(static_cast<quint64>(record.value(FDS_DB_CONTENT_HASH_INDEX).toLongLong()));
   m_networkError = QNetworkReply::NoError;
+  m_dateTimeFormat = TextFactory::UnknownDateTimeFormat;
 }
@@ -5,6 +5,8 @@
 
 #include "services/abstract/feed.h"
 
+#include "miscellaneous/textfactory.h"
+
 #include <QCoreApplication>
 #include <QDateTime>
 #include <QMetaType>
@@ -67,6 +69,17 @@ class StandardFeed : public Feed {
 
     QNetworkReply::NetworkError networkError() const;
 
+    bool prepareFetch(FetchRequest& request) const;
+
+    // HTTP validators used for conditional downloads.
+    QString httpETag() const;
+    QString httpLastModified() const;
+    void setHttpValidators(const QString& etag, const QString& last_modified);
+
+    // Hash of raw contents of last successfully stored download.
+    quint64 contentHash() const;
+    void setContentHash(quint64 content_hash);
+
     // Tries to guess feed hidden under given URL
     // and uses given credentials.
     // Returns pointer to guessed feed (if at least partially
@@ -82,8 +95,12 @@ class StandardFeed : public Feed {
   public slots:
     void fetchMetadataForItself();
 
+  protected:
+    bool saveFetchState(QSqlDatabase& database);
+    void applyFetchState();
+
   private:
-    QList<Message> obtainNewMessages(bool* error_during_obtaining);
+    QList<Message> obtainNewMessages(bool* error_during_obtaining, const CancellationToken& token);
 
   private:
     bool m_passwordProtected;
@@ -93,6 +110,18 @@ class StandardFeed : public Feed {
 
     QNetworkReply::NetworkError m_networkError;
     QString m_encoding;
+
+    // Validators/hash of last successfully stored contents and validators/hash
+    // obtained during running update, which are stored together with messages.
+    QString m_httpETag;
+    QString m_httpLastModified;
+    quint64 m_contentHash;
+    QString m_pendingHttpETag;
+    QString m_pendingHttpLastModified;
+    quint64 m_pendingContentHash;
+
+    // Date format detected during last parsing of feed.
+    TextFactory::DateTimeFormat m_dateTimeFormat;
 };
 
 Q_DECLARE_METATYPE(StandardFeed::Type)
@@ -94,7 +94,7 @@ TtRssLoginResponse TtRssNetworkFactory::login() {
                                                                         result_raw,
                                                                         QNetworkAccessManager::PostOperation,
                                                                         headers);
-  TtRssLoginResponse login_response(QString::fromUtf8(result_raw));
+  TtRssLoginResponse login_response(result_raw);
 
   if (network_reply.first == QNetworkReply::NoError) {
     m_sessionId = login_response.sessionId();
@@ -138,7 +138,7 @@ TtRssResponse TtRssNetworkFactory::logout() {
       qWarning("TT-RSS: Logout failed with error %d.", network_reply.first);
     }
 
-    return TtRssResponse(QString::fromUtf8(result_raw));
+    return TtRssResponse(result_raw);
   }
   else {
     qWarning("TT-RSS: Cannot logout because session ID is empty.");
@@ -165,7 +165,7 @@ TtRssGetFeedsCategoriesResponse TtRssNetworkFactory::getFeedsCategories() {
                                                                         result_raw,
                                                                         QNetworkAccessManager::PostOperation,
                                                                         headers);
-  TtRssGetFeedsCategoriesResponse result(QString::fromUtf8(result_raw));
+  TtRssGetFeedsCategoriesResponse result(result_raw);
 
   if (result.isNotLoggedIn()) {
     // We are not logged in.
@@ -175,7 +175,7 @@ TtRssGetFeedsCategoriesResponse TtRssNetworkFactory::getFeedsCategories() {
                                                             result_raw,
                                                             QNetworkAccessManager::PostOperation,
                                                             headers);
-    result = TtRssGetFeedsCategoriesResponse(QString::fromUtf8(result_raw));
+    result = TtRssGetFeedsCategoriesResponse(result_raw);
   }
 
   if (network_reply.first != QNetworkReply::NoError) {
@@ -212,7 +212,7 @@ TtRssGetHeadlinesResponse TtRssNetworkFactory::getHeadlines(int feed_id, int lim
                                                                         result_raw,
                                                                         QNetworkAccessManager::PostOperation,
                                                                         headers);
-  TtRssGetHeadlinesResponse result(QString::fromUtf8(result_raw));
+  TtRssGetHeadlinesResponse result(result_raw);
 
   if (result.isNotLoggedIn()) {
     // We are not logged in.
@@ -222,11 +222,9 @@ TtRssGetHeadlinesResponse TtRssNetworkFactory::getHeadlines(int feed_id, int lim
                                                             result_raw,
                                                             QNetworkAccessManager::PostOperation,
                                                             headers);
-    result = TtRssGetHeadlinesResponse(QString::fromUtf8(result_raw));
+    result = TtRssGetHeadlinesResponse(result_raw);
   }
 
-  IOFactory::writeFile("aaa", result_raw);
-
   if (network_reply.first != QNetworkReply::NoError) {
     qWarning("TT-RSS: getHeadlines failed with error %d.", network_reply.first);
   }
@@ -259,7 +257,7 @@ TtRssUpdateArticleResponse TtRssNetworkFactory::updateArticles(const QStringList
                                                                         result_raw,
                                                                         QNetworkAccessManager::PostOperation,
                                                                         headers);
-  TtRssUpdateArticleResponse result(QString::fromUtf8(result_raw));
+  TtRssUpdateArticleResponse result(result_raw);
 
   if (result.isNotLoggedIn()) {
     // We are not logged in.
@@ -269,7 +267,7 @@ TtRssUpdateArticleResponse TtRssNetworkFactory::updateArticles(const QStringList
                                                             result_raw,
                                                             QNetworkAccessManager::PostOperation,
                                                             headers);
-    result = TtRssUpdateArticleResponse(QString::fromUtf8(result_raw));
+    result = TtRssUpdateArticleResponse(result_raw);
   }
 
   if (network_reply.first != QNetworkReply::NoError) {
@@ -307,7 +305,7 @@ TtRssSubscribeToFeedResponse TtRssNetworkFactory::subscribeToFeed(const QString&
                                                                         result_raw,
                                                                         QNetworkAccessManager::PostOperation,
                                                                         headers);
-  TtRssSubscribeToFeedResponse result(QString::fromUtf8(result_raw));
+  TtRssSubscribeToFeedResponse result(result_raw);
 
   if (result.isNotLoggedIn()) {
     // We are not logged in.
@@ -317,7 +315,7 @@ TtRssSubscribeToFeedResponse TtRssNetworkFactory::subscribeToFeed(const QString&
                                                             result_raw,
                                                             QNetworkAccessManager::PostOperation,
                                                             headers);
-    result = TtRssSubscribeToFeedResponse(QString::fromUtf8(result_raw));
+    result = TtRssSubscribeToFeedResponse(result_raw);
   }
 
   if (network_reply.first != QNetworkReply::NoError) {
@@ -347,7 +345,7 @@ TtRssUnsubscribeFeedResponse TtRssNetworkFactory::unsubscribeFeed(int feed_id) {
                                                                         result_raw,
                                                                         QNetworkAccessManager::PostOperation,
                                                                         headers);
-  TtRssUnsubscribeFeedResponse result(QString::fromUtf8(result_raw));
+  TtRssUnsubscribeFeedResponse result(result_raw);
 
   if (result.isNotLoggedIn()) {
     // We are not logged in.
@@ -357,7 +355,7 @@ TtRssUnsubscribeFeedResponse TtRssNetworkFactory::unsubscribeFeed(int feed_id) {
                                                             result_raw,
                                                             QNetworkAccessManager::PostOperation,
                                                             headers);
-    result = TtRssUnsubscribeFeedResponse(QString::fromUtf8(result_raw));
+    result = TtRssUnsubscribeFeedResponse(result_raw);
   }
 
   if (network_reply.first != QNetworkReply::NoError) {
@@ -400,8 +398,8 @@ void TtRssNetworkFactory::setAuthPassword(const QString& auth_password) {
   m_authPassword = auth_password;
 }
 
-TtRssResponse::TtRssResponse(const QString& raw_content) {
-  m_rawContent = QJsonDocument::fromJson(raw_content.toUtf8()).object();
+TtRssResponse::TtRssResponse(const QByteArray& raw_content) {
+  m_rawContent = QJsonDocument::fromJson(raw_content).object();
 }
 
 TtRssResponse::~TtRssResponse() {}
@@ -436,7 +434,7 @@ QString TtRssResponse::toString() const {
   return QJsonDocument(m_rawContent).toJson(QJsonDocument::Compact);
 }
 
-TtRssLoginResponse::TtRssLoginResponse(const QString& raw_content) : TtRssResponse(raw_content) {}
+TtRssLoginResponse::TtRssLoginResponse(const QByteArray& raw_content) : TtRssResponse(raw_content) {}
 
 TtRssLoginResponse::~TtRssLoginResponse() {}
 
@@ -476,7 +474,7 @@ bool TtRssResponse::hasError() const {
   }
 }
 
-TtRssGetFeedsCategoriesResponse::TtRssGetFeedsCategoriesResponse(const QString& raw_content) : TtRssResponse(raw_content) {}
+TtRssGetFeedsCategoriesResponse::TtRssGetFeedsCategoriesResponse(const QByteArray& raw_content) : TtRssResponse(raw_content) {}
 
 TtRssGetFeedsCategoriesResponse::~TtRssGetFeedsCategoriesResponse() {}
 
@@ -563,7 +561,7 @@ RootItem* TtRssGetFeedsCategoriesResponse::feedsCategories(bool obtain_icons, QS
   return parent;
 }
 
-TtRssGetHeadlinesResponse::TtRssGetHeadlinesResponse(const QString& raw_content) : TtRssResponse(raw_content) {}
+TtRssGetHeadlinesResponse::TtRssGetHeadlinesResponse(const QByteArray& raw_content) : TtRssResponse(raw_content) {}
 
 TtRssGetHeadlinesResponse::~TtRssGetHeadlinesResponse() {}
 
@@ -571,7 +569,7 @@ QList<Message> TtRssGetHeadlinesResponse::messages() const {
   QList<Message> messages;
 
   foreach (const QJsonValue& item, m_rawContent["content"].toArray()) {
-    QJsonObject mapped = item.toObject();
+    const QJsonObject mapped = item.toObject();
     Message message;
 
     message.m_author = mapped["author"].toString();
@@ -591,7 +589,7 @@ QList<Message> TtRssGetHeadlinesResponse::messages() const {
     if (mapped.contains(QSL("attachments"))) {
       // Process enclosures.
       foreach (const QJsonValue& attachment, mapped["attachments"].toArray()) {
-        QJsonObject mapped_attachemnt = attachment.toObject();
+        const QJsonObject mapped_attachemnt = attachment.toObject();
         Enclosure enclosure;
 
         enclosure.m_mimeType = mapped_attachemnt["content_type"].toString();
@@ -606,7 +604,7 @@ QList<Message> TtRssGetHeadlinesResponse::messages() const {
   return messages;
 }
 
-TtRssUpdateArticleResponse::TtRssUpdateArticleResponse(const QString& raw_content) : TtRssResponse(raw_content) {}
+TtRssUpdateArticleResponse::TtRssUpdateArticleResponse(const QByteArray& raw_content) : TtRssResponse(raw_content) {}
 
 TtRssUpdateArticleResponse::~TtRssUpdateArticleResponse() {}
 
@@ -628,7 +626,7 @@ int TtRssUpdateArticleResponse::articlesUpdated() const {
   }
 }
 
-TtRssSubscribeToFeedResponse::TtRssSubscribeToFeedResponse(const QString& raw_content) : TtRssResponse(raw_content) {}
+TtRssSubscribeToFeedResponse::TtRssSubscribeToFeedResponse(const QByteArray& raw_content) : TtRssResponse(raw_content) {}
 
 TtRssSubscribeToFeedResponse::~TtRssSubscribeToFeedResponse() {}
 
@@ -641,7 +639,7 @@ int TtRssSubscribeToFeedResponse::code() const {
   }
 }
 
-TtRssUnsubscribeFeedResponse::TtRssUnsubscribeFeedResponse(const QString& raw_content) : TtRssResponse(raw_content) {}
+TtRssUnsubscribeFeedResponse::TtRssUnsubscribeFeedResponse(const QByteArray& raw_content) : TtRssResponse(raw_content) {}
 
 TtRssUnsubscribeFeedResponse::~TtRssUnsubscribeFeedResponse() {}
 
@@ -15,7 +15,7 @@ class TtRssFeed;
 
 class TtRssResponse {
   public:
-    explicit TtRssResponse(const QString& raw_content = QString());
+    explicit TtRssResponse(const QByteArray& raw_content = QByteArray());
     virtual ~TtRssResponse();
 
     bool isLoaded() const;
@@ -33,7 +33,7 @@ class TtRssResponse {
 
 class TtRssLoginResponse : public TtRssResponse {
   public:
-    explicit TtRssLoginResponse(const QString& raw_content = QString());
+    explicit TtRssLoginResponse(const QByteArray& raw_content = QByteArray());
     virtual ~TtRssLoginResponse();
 
     int apiLevel() const;
@@ -42,7 +42,7 @@ class TtRssLoginResponse : public TtRssResponse {
 
 class TtRssGetFeedsCategoriesResponse : public TtRssResponse {
   public:
-    explicit TtRssGetFeedsCategoriesResponse(const QString& raw_content = QString());
+    explicit TtRssGetFeedsCategoriesResponse(const QByteArray& raw_content = QByteArray());
     virtual ~TtRssGetFeedsCategoriesResponse();
 
     // Returns tree of feeds/categories.
@@ -53,7 +53,7 @@ class TtRssGetFeedsCategoriesResponse : public TtRssResponse {
 
 class TtRssGetHeadlinesResponse : public TtRssResponse {
   public:
-    explicit TtRssGetHeadlinesResponse(const QString& raw_content = QString());
+    explicit TtRssGetHeadlinesResponse(const QByteArray& raw_content = QByteArray());
     virtual ~TtRssGetHeadlinesResponse();
 
     QList<Message> messages() const;
@@ -61,7 +61,7 @@ class TtRssGetHeadlinesResponse : public TtRssResponse {
 
 class TtRssUpdateArticleResponse : public TtRssResponse {
   public:
-    explicit TtRssUpdateArticleResponse(const QString& raw_content = QString());
+    explicit TtRssUpdateArticleResponse(const QByteArray& raw_content = QByteArray());
     virtual ~TtRssUpdateArticleResponse();
 
     QString updateStatus() const;
@@ -70,7 +70,7 @@ class TtRssUpdateArticleResponse : public TtRssResponse {
 
 class TtRssSubscribeToFeedResponse : public TtRssResponse {
   public:
-    explicit TtRssSubscribeToFeedResponse(const QString& raw_content = QString());
+    explicit TtRssSubscribeToFeedResponse(const QByteArray& raw_content = QByteArray());
     virtual ~TtRssSubscribeToFeedResponse();
 
     int code() const;
@@ -78,7 +78,7 @@ class TtRssSubscribeToFeedResponse : public TtRssResponse {
 
 class TtRssUnsubscribeFeedResponse : public TtRssResponse {
   public:
-    explicit TtRssUnsubscribeFeedResponse(const QString& raw_content = QString());
+    explicit TtRssUnsubscribeFeedResponse(const QByteArray& raw_content = QByteArray());
     virtual ~TtRssUnsubscribeFeedResponse();
 
     QString code() const;
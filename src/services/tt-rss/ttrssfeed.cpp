@@ -4,6 +4,7 @@
 
 #include "definitions/definitions.h"
 #include "miscellaneous/application.h"
+#include "miscellaneous/cancellationtoken.h"
 #include "miscellaneous/databasequeries.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/textfactory.h"
@@ -67,7 +68,7 @@ bool TtRssFeed::editItself(TtRssFeed* new_feed_data) {
   }
 }
 
-QList<Message> TtRssFeed::obtainNewMessages(bool* error_during_obtaining) {
+QList<Message> TtRssFeed::obtainNewMessages(bool* error_during_obtaining, const CancellationToken& token) {
   QList<Message> messages;
   int newly_added_messages = 0;
   int limit = TTRSS_MAX_MESSAGES;
@@ -77,7 +78,11 @@ QList<Message> TtRssFeed::obtainNewMessages(bool* error_during_obtaining) {
     TtRssGetHeadlinesResponse headlines = serviceRoot()->network()->getHeadlines(customId().toInt(), limit, skip,
                                                                                  true, true, false);
 
-    if (serviceRoot()->network()->lastError() != QNetworkReply::NoError) {
+    if (token.isCancelled()) {
+      *error_during_obtaining = false;
+      return QList<Message>();
+    }
+    else if (serviceRoot()->network()->lastError() != QNetworkReply::NoError) {
       setStatus(Feed::NetworkError);
       *error_during_obtaining = true;
       serviceRoot()->itemChanged(QList<RootItem*>() << this);
@@ -28,7 +28,7 @@ class TtRssFeed : public Feed {
     bool removeItself();
 
   private:
-    QList<Message> obtainNewMessages(bool* error_during_obtaining);
+    QList<Message> obtainNewMessages(bool* error_during_obtaining, const CancellationToken& token);
 };
 
 #endif // TTRSSFEED_H
@@ -0,0 +1,100 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#include "allocationcounter.h"
+
+#include <atomic>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+static std::atomic<bool> s_tracking(false);
+static std::atomic<qint64> s_current(0);
+static std::atomic<qint64> s_peak(0);
+static std::atomic<qint64> s_allocations(0);
+
+static void trackAllocation(qint64 size) {
+  const qint64 current = s_current.fetch_add(size) + size;
+  qint64 peak = s_peak.load();
+
+  while (current > peak && !s_peak.compare_exchange_weak(peak, current)) {}
+
+  s_allocations++;
+}
+
+#if defined(__GLIBC__)
+
+extern "C" {
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t count, size_t size);
+  void* __libc_realloc(void* pointer, size_t size);
+  void __libc_free(void* pointer);
+
+  void* malloc(size_t size) {
+    void* pointer = __libc_malloc(size);
+
+    if (pointer != nullptr && s_tracking.load(std::memory_order_relaxed)) {
+      trackAllocation(qint64(malloc_usable_size(pointer)));
+    }
+
+    return pointer;
+  }
+
+  void* calloc(size_t count, size_t size) {
+    void* pointer = __libc_calloc(count, size);
+
+    if (pointer != nullptr && s_tracking.load(std::memory_order_relaxed)) {
+      trackAllocation(qint64(malloc_usable_size(pointer)));
+    }
+
+    return pointer;
+  }
+
+  void* realloc(void* pointer, size_t size) {
+    const qint64 old_size = pointer != nullptr ? qint64(malloc_usable_size(pointer)) : 0;
+    void* new_pointer = __libc_realloc(pointer, size);
+
+    if (new_pointer != nullptr && s_tracking.load(std::memory_order_relaxed)) {
+      s_current -= old_size;
+      trackAllocation(qint64(malloc_usable_size(new_pointer)));
+    }
+
+    return new_pointer;
+  }
+
+  void free(void* pointer) {
+    if (pointer != nullptr && s_tracking.load(std::memory_order_relaxed)) {
+      s_current -= qint64(malloc_usable_size(pointer));
+    }
+
+    __libc_free(pointer);
+  }
+}
+
+#endif
+
+AllocationCounter::AllocationCounter() {}
+
+bool AllocationCounter::isSupported() {
+#if defined(__GLIBC__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void AllocationCounter::start() {
+  s_current = 0;
+  s_peak = 0;
+  s_allocations = 0;
+  s_tracking = true;
+}
+
+qint64 AllocationCounter::stop() {
+  s_tracking = false;
+  return s_peak.load();
+}
+
+qint64 AllocationCounter::allocations() {
+  return s_allocations.load();
+}
@@ -0,0 +1,31 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+// Measures peak heap usage of a piece of code.
+// NOTE: Heap is tracked only with glibc where malloc() family
+// of functions is replaced by this benchmark, elsewhere
+// isSupported() returns false.
+class AllocationCounter {
+  private:
+
+    // Constructors and destructors.
+    AllocationCounter();
+
+  public:
+    static bool isSupported();
+
+    // Starts tracking, peak is measured relatively to current heap usage.
+    static void start();
+
+    // Stops tracking and returns peak count of allocated bytes since start().
+    static qint64 stop();
+
+    // Returns count of allocations made since start().
+    static qint64 allocations();
+};
+
+#endif // ALLOCATIONCOUNTER_H
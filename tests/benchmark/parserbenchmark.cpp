@@ -0,0 +1,394 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#include "parserbenchmark.h"
+
+#include "allocationcounter.h"
+#include "queryplanaudit.h"
+#include "core/messagesanitizer.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/textfactory.h"
+#include "network-web/webfactory.h"
+#include "services/owncloud/network/owncloudnetworkfactory.h"
+#include "services/standard/atomparser.h"
+#include "services/standard/rdfparser.h"
+#include "services/standard/rssparser.h"
+#include "services/tt-rss/network/ttrssnetworkfactory.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtTest>
+
+// How long each benchmark runs to measure its throughput, in miliseconds.
+#define BENCHMARK_REPORT_DURATION   500
+
+// Size of documents made from corpus files to benchmark huge feeds.
+#define BENCHMARK_HUGE_SIZE         (8 * 1024 * 1024)
+
+// Decodes JSON payload of some service and returns count of its messages.
+typedef std::function<int(const QByteArray&)> JsonDecoder;
+
+Q_DECLARE_METATYPE(JsonDecoder)
+
+void ParserBenchmark::rssParser_data() {
+  QTest::addColumn<QByteArray>("data");
+  QTest::addColumn<QByteArray>("fallback_encoding");
+  QTest::addColumn<int>("expected_items");
+  QTest::addColumn<bool>("exact");
+
+  addFeedRows(QSL("rss2-small.xml"), QByteArray(), 20, true, "<item>", "</item>");
+  addFeedRows(QSL("rss091-windows1250.xml"), QByteArray(), 12, true, "<item>", "</item>");
+  addFeedRows(QSL("rss2-truncated.xml"), QByteArray(), 9, false, QByteArray(), QByteArray());
+  addFeedRows(QSL("rss2-bare-ampersand.xml"), QByteArray(), 5, false, QByteArray(), QByteArray());
+}
+
+void ParserBenchmark::rssParser() {
+  QFETCH(QByteArray, data);
+  QFETCH(QByteArray, fallback_encoding);
+  int items = 0;
+
+  QBENCHMARK {
+    items = RssParser(data, fallback_encoding).messages().size();
+  }
+
+  checkItems(items);
+  report(data.size(), [&]() {
+    return RssParser(data, fallback_encoding).messages().size();
+  });
+}
+
+void ParserBenchmark::atomParser_data() {
+  QTest::addColumn<QByteArray>("data");
+  QTest::addColumn<QByteArray>("fallback_encoding");
+  QTest::addColumn<int>("expected_items");
+  QTest::addColumn<bool>("exact");
+
+  addFeedRows(QSL("atom10-small.xml"), QByteArray(), 20, true, "<entry>", "</entry>");
+  addFeedRows(QSL("atom10-utf16.xml"), QByteArray(), 20, true, QByteArray(), QByteArray());
+}
+
+void ParserBenchmark::atomParser() {
+  QFETCH(QByteArray, data);
+  QFETCH(QByteArray, fallback_encoding);
+  int items = 0;
+
+  QBENCHMARK {
+    items = AtomParser(data, fallback_encoding).messages().size();
+  }
+
+  checkItems(items);
+  report(data.size(), [&]() {
+    return AtomParser(data, fallback_encoding).messages().size();
+  });
+}
+
+void ParserBenchmark::rdfParser_data() {
+  QTest::addColumn<QByteArray>("data");
+  QTest::addColumn<QByteArray>("fallback_encoding");
+  QTest::addColumn<int>("expected_items");
+  QTest::addColumn<bool>("exact");
+
+  // This feed does not declare its encoding, it has to be given from outside.
+  addFeedRows(QSL("rdf-latin1.xml"), QByteArrayLiteral("ISO-8859-1"), 15, true, "<item ", "</item>");
+}
+
+void ParserBenchmark::rdfParser() {
+  QFETCH(QByteArray, data);
+  QFETCH(QByteArray, fallback_encoding);
+  int items = 0;
+
+  QBENCHMARK {
+    items = RdfParser(data, fallback_encoding).messages().size();
+  }
+
+  checkItems(items);
+  report(data.size(), [&]() {
+    return RdfParser(data, fallback_encoding).messages().size();
+  });
+}
+
+void ParserBenchmark::jsonResponses_data() {
+  QTest::addColumn<QByteArray>("data");
+  QTest::addColumn<int>("expected_items");
+  QTest::addColumn<bool>("exact");
+  QTest::addColumn<JsonDecoder>("decoder");
+
+  JsonDecoder ttrss = [](const QByteArray& data) {
+    return TtRssGetHeadlinesResponse(data).messages().size();
+  };
+  JsonDecoder nextcloud = [](const QByteArray& data) {
+    return OwnCloudGetMessagesResponse(data).messages().size();
+  };
+
+  QTest::newRow("ttrss-headlines.json") << corpusFile(QSL("ttrss-headlines.json")) << 25 << true << ttrss;
+  QTest::newRow("nextcloud-items.json") << corpusFile(QSL("nextcloud-items.json")) << 25 << true << nextcloud;
+}
+
+void ParserBenchmark::jsonResponses() {
+  QFETCH(QByteArray, data);
+  QFETCH(JsonDecoder, decoder);
+  int items = 0;
+
+  QBENCHMARK {
+    items = decoder(data);
+  }
+
+  checkItems(items);
+  report(data.size(), [&]() {
+    return decoder(data);
+  });
+}
+
+void ParserBenchmark::parseDateTime_data() {
+  QTest::addColumn<QStringList>("dates");
+  QTest::addColumn<int>("method");
+
+  const QStringList rfc822 = QStringList() << QSL("Mon, 03 Dec 2018 09:15:00 +0100") << QSL("Tue, 04 Dec 2018 17:02:11 GMT")
+                                           << QSL("Wed, 5 Dec 2018 08:00:00 EST") << QSL("Thu, 06 Dec 2018 23:59:59 PDT")
+                                           << QSL("Fri, 07 Dec 2018 12:00:00 +0000") << QSL("06 Dec 2018 06:30:00 -0500")
+                                           << QSL("Sun, 09 Dec 2018 10:10:10 UT") << QSL("Mon, 10 Dec 2018 14:45 +0530");
+  const QStringList iso8601 = QStringList() << QSL("2018-12-03T09:15:00+01:00") << QSL("2018-12-04T17:02:11Z")
+                                            << QSL("2018-12-05T08:00:00.123-05:00") << QSL("2018-12-06T23:59:59.5Z")
+                                            << QSL("2018-12-07") << QSL("2018-12-08 06:30:00") << QSL("2018-12-09T10:10Z")
+                                            << QSL("2018-12-10T14:45:00+0530");
+
+  // Method 0 is parsing with format hint, 1 without hint and 2 is
+  // original parsing with list of patterns.
+  QTest::newRow("rfc822 (hinted)") << rfc822 << 0;
+  QTest::newRow("rfc822") << rfc822 << 1;
+  QTest::newRow("rfc822 (patterns)") << rfc822 << 2;
+  QTest::newRow("iso8601 (hinted)") << iso8601 << 0;
+  QTest::newRow("iso8601") << iso8601 << 1;
+  QTest::newRow("iso8601 (patterns)") << iso8601 << 2;
+}
+
+void ParserBenchmark::parseDateTime() {
+  QFETCH(QStringList, dates);
+  QFETCH(int, method);
+  qint64 bytes = 0;
+
+  auto parse_all = [&]() {
+    TextFactory::DateTimeFormat format = TextFactory::UnknownDateTimeFormat;
+    int valid = 0;
+
+    foreach (const QString& date, dates) {
+      const QDateTime parsed = method == 0 ? TextFactory::parseDateTime(date, &format) :
+                               method == 1 ? TextFactory::parseDateTime(date) :
+                               TextFactory::parseDateTimeByPatterns(date);
+
+      if (parsed.isValid()) {
+        valid++;
+      }
+    }
+
+    return valid;
+  };
+  int valid = 0;
+
+  foreach (const QString& date, dates) {
+    bytes += date.size() * int(sizeof(QChar));
+  }
+
+  QBENCHMARK {
+    valid = parse_all();
+  }
+
+  if (method != 2) {
+    // Original parser does not understand all the dates.
+    QCOMPARE(valid, dates.size());
+  }
+
+  report(bytes, parse_all);
+}
+
+void ParserBenchmark::stripTags_data() {
+  QTest::addColumn<QStringList>("texts");
+
+  QStringList contents;
+
+  foreach (const Message& message, RssParser(corpusFile(QSL("rss2-small.xml"))).messages()) {
+    contents.append(message.m_contents);
+  }
+
+  QTest::newRow("rss2-small.xml contents") << contents;
+  QTest::newRow("huge document") << QStringList(contents.join(QString()).repeated(200));
+}
+
+void ParserBenchmark::stripTags() {
+  QFETCH(QStringList, texts);
+  qint64 bytes = 0;
+
+  auto strip_all = [&]() {
+    foreach (const QString& text, texts) {
+      qApp->web()->stripTags(text);
+    }
+
+    return texts.size();
+  };
+
+  foreach (const QString& text, texts) {
+    bytes += text.size() * int(sizeof(QChar));
+  }
+
+  QBENCHMARK {
+    strip_all();
+  }
+
+  QVERIFY(!qApp->web()->stripTags(texts.first()).contains(QL1C('<')));
+  report(bytes, strip_all);
+}
+
+void ParserBenchmark::htmlEntities_data() {
+  QTest::addColumn<QString>("text");
+  QTest::addColumn<bool>("encode");
+
+  const QString decoded = QSL("Tom & Jerry say \"<hello>\" – it's 5 × 3 ± 1. ").repeated(2000);
+  const QString encoded = QSL("Tom &amp; Jerry say &quot;&lt;hello&gt;&quot; &#8211; it&#039;s 5 &times; 3 &plusmn; 1. ").repeated(2000);
+
+  QTest::newRow("decode") << encoded << false;
+  QTest::newRow("encode") << decoded << true;
+}
+
+void ParserBenchmark::htmlEntities() {
+  QFETCH(QString, text);
+  QFETCH(bool, encode);
+  QString result;
+
+  QBENCHMARK {
+    result = encode ? qApp->web()->deEscapeHtml(text) : qApp->web()->escapeHtml(text);
+  }
+
+  // Encoding and decoding must be symmetric.
+  if (encode) {
+    QCOMPARE(qApp->web()->escapeHtml(result), text);
+  }
+  else {
+    QVERIFY(!result.contains(QL1S("&amp;")));
+  }
+
+  report(text.size() * int(sizeof(QChar)), [&]() {
+    result = encode ? qApp->web()->deEscapeHtml(text) : qApp->web()->escapeHtml(text);
+    return 1;
+  });
+}
+
+void ParserBenchmark::sanitizeMessages() {
+  const QList<Message> messages = RssParser(corpusFile(QSL("rss2-small.xml"))).messages();
+  qint64 bytes = 0;
+
+  // Copies are detached by sanitizer, this is included in results.
+  auto sanitize_all = [&]() {
+    QList<Message> copies = messages;
+
+    for (int i = 0; i < copies.size(); i++) {
+      MessageSanitizer::sanitize(copies[i]);
+    }
+
+    return copies.size();
+  };
+
+  foreach (const Message& message, messages) {
+    bytes += (message.m_title.size() + message.m_contents.size() + message.m_url.size()) * int(sizeof(QChar));
+  }
+
+  QBENCHMARK {
+    sanitize_all();
+  }
+
+  report(bytes, sanitize_all);
+}
+
+void ParserBenchmark::addFeedRows(const QString& file_name, const QByteArray& fallback_encoding, int expected_items,
+                                  bool exact, const QByteArray& item_start, const QByteArray& item_end) {
+  const QByteArray data = corpusFile(file_name);
+
+  QTest::newRow(qPrintable(file_name)) << data << fallback_encoding << expected_items << exact;
+
+  if (!item_start.isEmpty()) {
+    int copies;
+    const QByteArray huge_data = inflateDocument(data, item_start, item_end, BENCHMARK_HUGE_SIZE, copies);
+
+    QTest::newRow(qPrintable(file_name + QSL(" (huge)"))) << huge_data << fallback_encoding << expected_items * copies << exact;
+  }
+}
+
+void ParserBenchmark::checkItems(int items) {
+  QFETCH(int, expected_items);
+  QFETCH(bool, exact);
+
+  if (exact) {
+    QCOMPARE(items, expected_items);
+  }
+  else {
+    // Malformed documents must yield at least all complete items.
+    QVERIFY2(items >= expected_items, qPrintable(QString::number(items)));
+  }
+}
+
+void ParserBenchmark::report(qint64 bytes, const std::function<int()>& function) {
+  QElapsedTimer timer;
+  qint64 items = 0;
+  int runs = 0;
+
+  timer.start();
+
+  do {
+    items += function();
+    runs++;
+  } while (timer.elapsed() < BENCHMARK_REPORT_DURATION);
+
+  const double seconds = timer.nsecsElapsed() / 1000000000.0;
+  const char* name = QTest::currentDataTag() != nullptr ? QTest::currentDataTag() : QTest::currentTestFunction();
+
+  if (AllocationCounter::isSupported()) {
+    AllocationCounter::start();
+    function();
+
+    const qint64 peak = AllocationCounter::stop();
+
+    qDebug("%s: %.2f MB/s, %.0f items/s, peak heap %.1f KB in %lld allocations.",
+           name, bytes * runs / seconds / 1048576.0, items / seconds,
+           peak / 1024.0, AllocationCounter::allocations());
+  }
+  else {
+    qDebug("%s: %.2f MB/s, %.0f items/s.", name, bytes * runs / seconds / 1048576.0, items / seconds);
+  }
+}
+
+QByteArray ParserBenchmark::corpusFile(const QString& file_name) {
+  QFile file(QSL(BENCHMARK_CORPUS_DIR) + QL1C('/') + file_name);
+
+  if (!file.open(QIODevice::ReadOnly)) {
+    qFatal("Corpus file '%s' cannot be read.", qPrintable(file.fileName()));
+  }
+
+  return file.readAll();
+}
+
+QByteArray ParserBenchmark::inflateDocument(const QByteArray& data, const QByteArray& item_start,
+                                            const QByteArray& item_end, int target_size, int& copies) {
+  const int start = data.indexOf(item_start);
+  const int end = data.lastIndexOf(item_end) + item_end.size();
+  const QByteArray items = data.mid(start, end - start);
+  QByteArray result;
+
+  result.reserve(target_size + data.size());
+  result.append(data.constData(), start);
+
+  for (copies = 0; result.size() < target_size; copies++) {
+    result.append(items);
+  }
+
+  result.append(data.constData() + end, data.size() - end);
+  return result;
+}
+
+int main(int argc, char* argv[]) {
+  // Parsers use web factory of application instance.
+  Application application(QSL("rssguard-benchmark"), argc, argv);
+  ParserBenchmark benchmark;
+  QueryPlanAudit query_plan_audit;
+  int result = QTest::qExec(&benchmark, argc, argv);
+
+  result |= QTest::qExec(&query_plan_audit, argc, argv);
+  return result;
+}
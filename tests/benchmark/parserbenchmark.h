@@ -0,0 +1,51 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#ifndef PARSERBENCHMARK_H
+#define PARSERBENCHMARK_H
+
+#include <QObject>
+
+#include <QByteArray>
+
+#include <functional>
+
+// Benchmarks of feed parsers and text processing run over corpus of
+// feeds and service API payloads. Each benchmark also checks count
+// of parsed items, so that corpus doubles as regression test.
+class ParserBenchmark : public QObject {
+  Q_OBJECT
+
+  private slots:
+    void rssParser_data();
+    void rssParser();
+    void atomParser_data();
+    void atomParser();
+    void rdfParser_data();
+    void rdfParser();
+    void jsonResponses_data();
+    void jsonResponses();
+    void parseDateTime_data();
+    void parseDateTime();
+    void stripTags_data();
+    void stripTags();
+    void htmlEntities_data();
+    void htmlEntities();
+    void sanitizeMessages();
+
+  private:
+    void addFeedRows(const QString& file_name, const QByteArray& fallback_encoding, int expected_items, bool exact,
+                     const QByteArray& item_start, const QByteArray& item_end);
+    void checkItems(int items);
+
+    // Prints throughput of "function" which processes given count
+    // of bytes and returns count of processed items.
+    void report(qint64 bytes, const std::function<int()>& function);
+
+    static QByteArray corpusFile(const QString& file_name);
+
+    // Makes huge document by repeating items of given document.
+    static QByteArray inflateDocument(const QByteArray& data, const QByteArray& item_start,
+                                      const QByteArray& item_end, int target_size, int& copies);
+};
+
+#endif // PARSERBENCHMARK_H
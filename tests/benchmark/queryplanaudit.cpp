@@ -0,0 +1,112 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#include "queryplanaudit.h"
+
+#include "core/messagesmodelsqllayer.h"
+#include "definitions/definitions.h"
+#include "miscellaneous/databasequeries.h"
+
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QtTest>
+
+#define QUERY_PLAN_AUDIT_CONNECTION "query_plan_audit"
+
+void QueryPlanAudit::initTestCase() {
+  m_database = QSqlDatabase::addDatabase(QSL(APP_DB_SQLITE_DRIVER), QSL(QUERY_PLAN_AUDIT_CONNECTION));
+  m_database.setDatabaseName(QSL(":memory:"));
+  QVERIFY2(m_database.open(), qPrintable(m_database.lastError().text()));
+
+  QFile file_init(APP_SQL_PATH + QDir::separator() + APP_DB_SQLITE_INIT);
+
+  QVERIFY(file_init.open(QIODevice::ReadOnly | QIODevice::Text));
+
+  const QStringList statements = QString(file_init.readAll()).split(APP_DB_COMMENT_SPLIT, QString::SkipEmptyParts);
+  QSqlQuery query(m_database);
+
+  foreach (const QString& statement, statements) {
+    QVERIFY2(query.exec(statement), qPrintable(query.lastError().text()));
+  }
+}
+
+void QueryPlanAudit::cleanupTestCase() {
+  m_database.close();
+  m_database = QSqlDatabase();
+  QSqlDatabase::removeDatabase(QSL(QUERY_PLAN_AUDIT_CONNECTION));
+}
+
+void QueryPlanAudit::hotQueries_data() {
+  QTest::addColumn<QString>("sql");
+
+  const QStringList feed_ids = QStringList() << QSL("'1'") << QSL("'2'") << QSL("'3'");
+
+  // Counts of messages, see DatabaseQueries::getMessageCountsFor*().
+  QTest::newRow("counts-category-total") << DatabaseQueries::messageCountsForCategorySql(true);
+  QTest::newRow("counts-category-unread") << DatabaseQueries::messageCountsForCategorySql(false);
+  QTest::newRow("counts-account-total") << DatabaseQueries::messageCountsForAccountSql(true);
+  QTest::newRow("counts-account-unread") << DatabaseQueries::messageCountsForAccountSql(false);
+  QTest::newRow("counts-feed-total") << DatabaseQueries::messageCountsForFeedSql(true);
+  QTest::newRow("counts-feed-unread") << DatabaseQueries::messageCountsForFeedSql(false);
+  QTest::newRow("counts-bin-total") << DatabaseQueries::messageCountsForBinSql(true);
+  QTest::newRow("counts-bin-unread") << DatabaseQueries::messageCountsForBinSql(false);
+
+  // Existing messages, see DatabaseQueries::updateMessages().
+  QTest::newRow("existing-by-hash") << DatabaseQueries::existingMessagesByHashSql(3);
+  QTest::newRow("missing-identity-hashes") << DatabaseQueries::messagesWithoutIdentityHashSql();
+  QTest::newRow("existing-by-custom-id") << DatabaseQueries::existingMessagesByCustomIdSql(3);
+  QTest::newRow("assign-missing-custom-ids") << DatabaseQueries::assignMissingCustomIdsSql();
+
+  // Recent messages of feeds, see DatabaseQueries::getPublishingHistoryForFeeds().
+  QTest::newRow("publishing-history") << DatabaseQueries::publishingHistorySql();
+
+  // Messages displayed in the list, see ServiceRoot::loadMessagesForItem()
+  // and MessagesModelSqlLayer::selectStatement().
+  QTest::newRow("model-feeds")
+    << MessagesModelSqlLayer::selectStatement(QSL("Messages.id, Messages.title"),
+                                              DatabaseQueries::messagesFilterForFeeds(feed_ids, 1));
+  QTest::newRow("model-bin")
+    << MessagesModelSqlLayer::selectStatement(QSL("Messages.id, Messages.title"),
+                                              DatabaseQueries::messagesFilterForBin(1));
+}
+
+void QueryPlanAudit::hotQueries() {
+  QFETCH(QString, sql);
+
+  QSqlQuery query(m_database);
+
+  QVERIFY2(query.prepare(QSL("EXPLAIN QUERY PLAN ") + sql), qPrintable(query.lastError().text()));
+
+  // Plan does not depend on bound values, so any value is fine.
+  QRegularExpressionMatchIterator named_placeholders = QRegularExpression(QSL(":\\w+")).globalMatch(sql);
+
+  while (named_placeholders.hasNext()) {
+    query.bindValue(named_placeholders.next().captured(), 1);
+  }
+
+  for (int i = 0; i < sql.count(QL1C('?')); i++) {
+    query.addBindValue(1);
+  }
+
+  QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+
+  QStringList plan;
+
+  while (query.next()) {
+    // Last column contains human-readable description of the step.
+    plan.append(query.value(3).toString());
+  }
+
+  QVERIFY(!plan.isEmpty());
+
+  foreach (const QString& step, plan) {
+    // Older SQLite versions print "SCAN TABLE <table>", newer ones "SCAN <table>".
+    const bool full_scan = step.startsWith(QL1S("SCAN ")) &&
+                           (step.contains(QL1S(" Messages")) || step.contains(QL1S(" Feeds")));
+
+    QVERIFY2(!full_scan, qPrintable(QString(QSL("Query falls back to full scan: '%1', plan: '%2'."))
+                                    .arg(sql, plan.join(QSL("; ")))));
+  }
+}
@@ -0,0 +1,26 @@
+// For license of this file, see <project-root-folder>/LICENSE.md.
+
+#ifndef QUERYPLANAUDIT_H
+#define QUERYPLANAUDIT_H
+
+#include <QObject>
+
+#include <QSqlDatabase>
+
+// Checks plans of hot queries over "Messages" table in SQLite database
+// created by initialization script. Audit fails if any of the queries
+// scans whole table or whole index instead of searching it.
+class QueryPlanAudit : public QObject {
+  Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void hotQueries_data();
+    void hotQueries();
+
+  private:
+    QSqlDatabase m_database;
+};
+
+#endif // QUERYPLANAUDIT_H